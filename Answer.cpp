@@ -18,10 +18,13 @@
 #include <queue>
 #include <bitset>
 #include <tuple>
+#include <cstdint>
 //#include <chrono>       // std::chrono::system_clock
 //https://ja.wikipedia.org/wiki/Composite_%E3%83%91%E3%82%BF%E3%83%BC%E3%83%B3
 
 #include "HPCAnswer.hpp"
+#include "HPCFieldDistance.hpp"
+#include "HPCLevelDesigner.hpp"
 #include "HPCMath.hpp"
 
 namespace {
@@ -34,8 +37,17 @@ namespace {
 
     constexpr int kMAX_GROUPS = 9;
     constexpr int kMAX_WEIGHT = 4;
-    constexpr int kLOOP_MAX_MAX = 1000;
     constexpr int kCOEFF = 3;
+    constexpr int kBEAM_WIDTH = 64;         //ビームサーチで時間帯ごとに残す状態の数
+    constexpr int kBEAM_WIDTH_WIDE = 1024;  //時間をかけてよいとき
+    constexpr size_t kARENA_BLOCK = 64*1024; //1ステージの作業領域はこれに収まる
+    //全ステージの持ち時間。制限時間がなければコンテストの制限(1周480ステージで15秒)に合わせる
+    constexpr double kTIME_LIMIT_SEC = Parameter::GameTimeLimitSec!=0 ? Parameter::GameTimeLimitSec : 15.0*Parameter::RepeatCount;
+    constexpr double kTIME_RESERVE = 0.2; //シミュレーション自体にかかる時間などに残しておく割合
+    constexpr double kWORK_PER_SEC = 4e8; //1秒で調べられる状態の数。手元で測った速さの半分にして余裕を持たせる
+    //全ステージで使ってよい仕事量。使い切っても持ち時間に収まる
+    constexpr double kWORK_TOTAL = kWORK_PER_SEC*kTIME_LIMIT_SEC*(1.0-kTIME_RESERVE);
+    constexpr long kLOCAL_WORK_PER_PAIR = 16; //局所探索で荷物の組ごとに試す手の数の見積もり。手元では多くても3程度
     template<class T = int> inline bool within(T min_x, T x, T max_x){ return min_x<=x&&x<max_x; }
     
     template<class T = int>
@@ -73,7 +85,128 @@ namespace {
         }
     };
 
-    class BFSQuery{ public: int x,y,d; };
+    //ステージごとの作業領域。先頭から詰めて確保するだけで、個別には解放せず、ステージの頭でまとめて捨てる。
+    //足りなくなったらブロックを足すが、足したブロックは捨てずに次のステージでも使う。
+    class Arena{
+     public:
+        explicit Arena(size_t block_size):blocks_(1,vector<char>(block_size)),block_size_(block_size),block_(0),used_(0){}
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        void reset(){ block_ = 0; used_ = 0; }
+        void* allocate(size_t bytes,size_t align){
+            while(true){
+                vector<char>& block = blocks_[block_];
+                uintptr_t head = reinterpret_cast<uintptr_t>(block.data())+used_;
+                size_t pad = (align-head%align)%align;
+                if(used_+pad+bytes<=block.size()){
+                    used_ += pad+bytes;
+                    return block.data()+used_-bytes;
+                }
+                ++block_;
+                used_ = 0;
+                if(block_==blocks_.size()) blocks_.emplace_back(max(block_size_,bytes+align));
+            }
+        }
+     private:
+        vector<vector<char>> blocks_;
+        size_t block_size_;
+        size_t block_;  //使用中のブロック
+        size_t used_;   //使用中のブロックで使った大きさ
+    };
+
+    //Arenaから確保するアロケータ。解放は何もしない
+    template<class T>
+    class ArenaAllocator{
+     public:
+        typedef T value_type;
+        explicit ArenaAllocator(Arena* arena):arena_(arena){}
+        template<class U> ArenaAllocator(const ArenaAllocator<U>& rhs):arena_(rhs.arena()){}
+
+        T* allocate(size_t n){ return static_cast<T*>(arena_->allocate(n*sizeof(T),alignof(T))); }
+        void deallocate(T*,size_t){}
+        Arena* arena() const{ return arena_; }
+     private:
+        Arena* arena_;
+    };
+    template<class T,class U> inline bool operator==(const ArenaAllocator<T>& a,const ArenaAllocator<U>& b){ return a.arena()==b.arena(); }
+    template<class T,class U> inline bool operator!=(const ArenaAllocator<T>& a,const ArenaAllocator<U>& b){ return a.arena()!=b.arena(); }
+    template<class T> using avector = vector<T,ArenaAllocator<T>>;
+    typedef avector<avector<int>> Plan; //時間帯ごとの荷物の並び
+
+    //1ステージ分の行動を1手2ビットで詰めた列。時間帯の区切りも持つ。
+    //ステージのターン数より多い手は実行されないので、容量はターン数で固定する
+    class ActionStream{
+     public:
+        ActionStream():size_(0),periods_(0){}
+        inline void clear(){ size_ = 0; periods_ = 0; }
+        inline void push(Action a){
+            if(size_==kCAPACITY) return; //ターン切れになる計画。これ以上は使われない
+            const int shift = (size_&31)*2;
+            uint64_t& word = words_[size_>>5];
+            word = (word&~(uint64_t(3)<<shift))|(uint64_t(a)<<shift);
+            ++size_;
+        }
+        inline void close_period(){ period_end_[periods_++] = size_; }
+        inline Action operator[](int i) const{ return Action((words_[i>>5]>>((i&31)*2))&3); }
+        inline int size() const{ return size_; }
+        inline int period_begin(int period) const{ return period==0 ? 0 : period_end_[period-1]; }
+        inline int period_end(int period) const{ return period_end_[period]; }
+     private:
+        static constexpr int kCAPACITY = Parameter::GameTurnPerStage;
+        uint64_t words_[(kCAPACITY+31)/32];
+        int size_;
+        int periods_;
+        int period_end_[Parameter::PeriodCount];
+    };
+
+    //探索に使ってよい仕事量。時計ではなく調べた状態の数の累計で数えるので、
+    //同じステージなら、直列でも並列でも、何度実行しても同じ計画になる
+    class WorkBudget{
+     public:
+        WorkBudget():limit_(numeric_limits<long>::max()){}
+        explicit WorkBudget(long limit):limit_(limit){}
+        inline bool allows(long work) const{ return work<=limit_; }
+     private:
+        long limit_;
+    };
+
+    //ステージ番号ごとの仕事量の割り当て。ステージ番号の順に、残りの仕事量を残りのステージで難しさの3乗に比例して分ける。
+    //ステージが使い切れない分は後のステージに回す。荷物の数も時間帯指定の数もステージ番号だけで決まるので、
+    //割り当てはステージを実行する順番やスレッドによらない
+    class WorkSchedule{
+     public:
+        WorkSchedule(){
+            long weight_sum = 0;
+            for(int number = 0; number < Parameter::GameStageCount; ++number){ weight_sum += weight(number); }
+            double rest = kWORK_TOTAL;
+            for(int number = 0; number < Parameter::GameStageCount; ++number){
+                const double share = rest*weight(number)/weight_sum;
+                limits_[number] = static_cast<long>(share);
+                rest -= min(share,static_cast<double>(demand(number)));
+                weight_sum -= weight(number);
+            }
+        }
+        inline WorkBudget budget(int number) const{ return WorkBudget(limits_[number]); }
+     private:
+        //割り当ての状態数は時間帯指定のない荷物の数に対して指数的に増えるので、荷物の数と合わせた難しさの3乗で分ける
+        static long weight(int number){
+            const int count = LevelDesigner::ItemCount(number);
+            const long difficulty = 2*count-LevelDesigner::PeriodSpecifiedCount(number);
+            return difficulty*difficulty*difficulty;
+        }
+        //ステージが使える仕事量の上限。partitionの列挙は前半と後半それぞれ2*3^free+2^(free+1)を超えない
+        static long demand(int number){
+            const int count = LevelDesigner::ItemCount(number);
+            const int free = count-LevelDesigner::PeriodSpecifiedCount(number);
+            long enumeration = 4;
+            for(int i = 0; i < free; ++i){ enumeration *= 3; }
+            return enumeration+(4L<<free)+kLOCAL_WORK_PER_PAIR*count*count;
+        }
+        long limits_[Parameter::GameStageCount];
+    };
+    const WorkSchedule work_schedule;
+
     class UniteQuery{
      public:
         int a,b,d;
@@ -82,13 +215,13 @@ namespace {
     
     class UnionFind{
      private:
-      std::vector<int> p_gs_; //正なら親ノードの番号で負なら自身がルートで値は-groupsize
+      avector<int> p_gs_;     //正なら親ノードの番号で負なら自身がルートで値は-groupsize
       int groups_;            //groupの数
 
      public:
       const int nodes;        //ノードの数
 
-      UnionFind(int size):p_gs_(size, -1),groups_(size),nodes(size){}
+      UnionFind(int size,const ArenaAllocator<int>& alloc):p_gs_(size, -1, alloc),groups_(size),nodes(size){}
 
       bool unite(int x, int y){
         int rx = root(x), ry = root(y);
@@ -108,153 +241,397 @@ namespace {
     };
     constexpr int dxy[] = {-1,0,1,0,0,-1,0,1};
 
-    class MindSet{ public: /*virtual think(){}*/ };
+    constexpr int kHK_INF = 1<<29; //Held-Karpの未到達。足しても溢れない大きさ
+    //最下位の立っているビットの位置(de Bruijn列)
+    constexpr int kDEBRUIJN[32] = {0,1,28,2,29,14,24,3,30,22,20,15,25,17,4,8,31,27,13,23,21,19,16,7,26,12,18,6,11,5,10,9};
+    inline int lowest_bit(uint32_t b){ return kDEBRUIJN[((b&(0u-b))*0x077CB531u)>>27]; }
+
+    //Routeが距離を引く地点。荷物の番号と営業所
+    constexpr int kNODES = BITS+1;
+    constexpr int kHOME_NODE = BITS;
+
+    //1つの時間帯の巡回路。営業所→荷物→…→営業所を、区間の距離と残りの重さの累積和とともに持つ。
+    //燃料は区間の距離×(トラック+まだ積んでいる荷物)なので、順番を変えると後ろの区間の重さも変わるが、
+    //累積和を使えば2-opt、Or-opt、入れ替え、他の時間帯への移動での燃料の増減をO(1)で求められる。
+    //距離は対称(どちら向きでも同じ)であることを使う。
+    class Route{
+     public:
+        inline void assign(const avector<int>& seq,const uint16_t* pdist,const int* pweight){
+            pdist_ = pdist;
+            pweight_ = pweight;
+            size_ = seq.size();
+            nodes_[0] = nodes_[size_+1] = kHOME_NODE;
+            copy(seq.begin(),seq.end(),nodes_+1);
+            rebuild();
+        }
+        inline void write(avector<int>& seq) const{ seq.assign(nodes_+1,nodes_+1+size_); }
+        inline int size() const{ return size_; }
+        inline int node(int i) const{ return nodes_[i]; } //1～size()が荷物
+        inline int weight() const{ return rest_[0]; }
+        inline int cost() const{ return Parameter::TruckWeight*pre_dist_[size_+1]+pre_dr_[size_+1]; }
+
+        //i～j番目(1≦i<j≦size)を逆順にしたときの燃料の増減
+        inline int delta_reverse(int i,int j) const{
+            return (d(i-1,j)-leg_[i-1])*load(i)+(d(i,j+1)-leg_[j])*load(j+1)
+                +(rest_[i]+rest_[j+1])*dist(i,j)-2*dr(i,j);
+        }
+        //i～j番目をq番目の後ろ(q<i-1かj<q)へそのまま移したときの燃料の増減を、全部のqについてdeltas[q]に書く。
+        //i-1～j番目は書かない。前後それぞれ分岐のない同じ式なので、コンパイラがqをレーンに並べて計算できる
+        inline void delta_moves(int i,int j,int* deltas) const{
+            const int w = rest_[i]-rest_[j+1];
+            const int span = dist(i,j);
+            const int cut = leg_[i-1]*load(i)+leg_[j]*load(j+1);
+            const uint16_t* from_j = pdist_+nodes_[j]*kNODES;
+            int to_i[BITS+1];
+            gather_to(nodes_[i],to_i);
+            for(int q = 0; q < i-1; ++q){
+                const int l = Parameter::TruckWeight+rest_[q+1];
+                deltas[q] = to_i[q]*l+from_j[nodes_[q+1]]*(l-w)+d(i-1,j+1)*load(j+1)
+                    -w*(pre_dist_[i-1]-pre_dist_[q+1])+(rest_[q+1]-rest_[i])*span-cut-leg_[q]*l;
+            }
+            for(int q = j+1; q <= size_; ++q){
+                const int l = Parameter::TruckWeight+rest_[q+1];
+                deltas[q] = d(i-1,j+1)*load(i)+to_i[q]*(l+w)+from_j[nodes_[q+1]]*l
+                    +w*(pre_dist_[q]-pre_dist_[j+1])+(rest_[q+1]-rest_[j+1])*span-cut-leg_[q]*l;
+            }
+        }
+        //i番目とj番目(1≦i<j≦size)を入れ替えたときの燃料の増減
+        inline int delta_swap(int i,int j) const{
+            if(j==i+1) return delta_reverse(i,j);
+            //間の区間ではi番目の荷物を積んでいてj番目の荷物を降ろしている
+            const int w = pweight_[nodes_[i]]-pweight_[nodes_[j]];
+            return (d(i-1,j)-leg_[i-1])*load(i)
+                +dd(nodes_[j],nodes_[i+1])*(load(i+1)+w)-leg_[i]*load(i+1)
+                +w*dist(i+1,j-1)
+                +dd(nodes_[j-1],nodes_[i])*(load(j)+w)-leg_[j-1]*load(j)
+                +(d(i,j+1)-leg_[j])*load(j+1);
+        }
+        //i番目を取り除いたときの燃料の増減
+        inline int delta_remove(int i) const{
+            return -pweight_[nodes_[i]]*dist(0,i-1)
+                +d(i-1,i+1)*load(i+1)-leg_[i-1]*load(i)-leg_[i]*load(i+1);
+        }
+        //荷物xをq番目の後ろに入れたときの燃料の増減を、0≦q≦sizeの全部についてdeltas[q]に書く
+        inline void delta_inserts(int x,int* deltas) const{
+            const int w = pweight_[x];
+            const uint16_t* from_x = pdist_+x*kNODES;
+            int to_x[BITS+1];
+            gather_to(x,to_x);
+            for(int q = 0; q <= size_; ++q){
+                const int l = Parameter::TruckWeight+rest_[q+1];
+                deltas[q] = w*pre_dist_[q]+to_x[q]*(l+w)+(from_x[nodes_[q+1]]-leg_[q])*l;
+            }
+        }
+
+        inline void reverse(int i,int j){
+            std::reverse(nodes_+i,nodes_+j+1);
+            rebuild();
+        }
+        inline void move(int i,int j,int q){
+            if(j<q){
+                rotate(nodes_+i,nodes_+j+1,nodes_+q+1);
+            }else{
+                rotate(nodes_+q+1,nodes_+i,nodes_+j+1);
+            }
+            rebuild();
+        }
+        inline void swap(int i,int j){
+            std::swap(nodes_[i],nodes_[j]);
+            rebuild();
+        }
+        inline void remove(int i){
+            copy(nodes_+i+1,nodes_+size_+2,nodes_+i);
+            --size_;
+            rebuild();
+        }
+        inline void insert(int q,int x){
+            copy_backward(nodes_+q+1,nodes_+size_+2,nodes_+size_+3);
+            nodes_[q+1] = x;
+            ++size_;
+            rebuild();
+        }
+
+     private:
+        const uint16_t* pdist_;
+        const int* pweight_;
+        int size_;
+        int nodes_[BITS+2];    //両端は営業所
+        int leg_[BITS+1];      //nodes_[t]からnodes_[t+1]への距離
+        int rest_[BITS+2];     //nodes_[t]から後ろで配る荷物の重さ
+        int pre_dist_[BITS+2]; //leg_[0]～leg_[t-1]の和
+        int pre_dr_[BITS+2];   //leg_[s]*rest_[s+1]のs<tでの和
+
+        inline int dd(int a,int b) const{ return pdist_[a*kNODES+b]; }
+        inline int d(int i,int j) const{ return dd(nodes_[i],nodes_[j]); }
+        inline int load(int i) const{ return Parameter::TruckWeight+rest_[i]; } //nodes_[i]へ向かう区間の重さ
+        inline int dist(int i,int j) const{ return i<j ? pre_dist_[j]-pre_dist_[i] : 0; } //leg_[i]～leg_[j-1]の和
+        //0～size番目の地点からxへの距離を並べる。まとめて計算する前に、飛び飛びの読み出しを先に済ませておく
+        inline void gather_to(int x,int* to) const{
+            for(int q = 0; q <= size_; ++q){ to[q] = dd(nodes_[q],x); }
+        }
+        inline int dr(int i,int j) const{ return pre_dr_[j]-pre_dr_[i]; }
+
+        //受け入れた手の後で累積和を作り直す。荷物は高々BITS個なので、差分を追うより単純に全部やり直す
+        inline void rebuild(){
+            rest_[size_+1] = 0;
+            for(int t = size_; 0 <= t; --t){ rest_[t] = rest_[t+1]+pweight_[nodes_[t]]; }
+            pre_dist_[0] = pre_dr_[0] = 0;
+            for(int t = 0; t <= size_; ++t){
+                leg_[t] = d(t,t+1);
+                pre_dist_[t+1] = pre_dist_[t]+leg_[t];
+                pre_dr_[t+1] = pre_dr_[t]+leg_[t]*rest_[t+1];
+            }
+        }
+    };
+
+    class Brain;
+    //荷物をどの時間帯に配るかを決める解法。Brainが距離や集合ごとの燃料を用意したあとに呼ばれる。
+    //時間帯の中の順番はあとでBrainが最小のものに並べ直すので、決めるのは分け方だけでよい
+    class MindSet{
+     public:
+        virtual ~MindSet(){}
+        virtual const char* name() const = 0;
+        virtual void think(Brain& brain,Plan& items,const WorkBudget& budget) const = 0;
+    };
 
     class Brain{
      public:
-        Brain(){};
+        Brain():arena_(kARENA_BLOCK),plan_items_(alloc()),field_(nullptr),items_(nullptr),
+            hk_dp_((1<<BITS)*BITS,kHK_INF),hk_weight_(1<<BITS,0),
+            part_cost_(Parameter::PeriodCount,vector<int>(1<<BITS,kHK_INF)),
+            part_choice_(Parameter::PeriodCount,vector<uint16_t>(1<<BITS,0)),
+            beam_(alloc<avector<BeamState>>()),beam_slot_(1<<BITS,-1){};
 
         inline void init(const Stage& aStage){
-            items_ = aStage.items();
-            field_ = aStage.field();
-
-            memo_.clear();
-            num_of_items_ = items_.count();
-            width_ = field_.width();
-            height_ = field_.height();
-            home_ = field_.officePos();
-            build_dmap();
+            //前のステージの作業領域をまとめて捨てる。Arenaを使うメンバーは先に空にしておき、
+            //捨てた領域を後から触らないようにする。Arenaを使うコンテナはこのあと作り直す
+            plan_items_ = Plan(alloc());
+            beam_ = avector<avector<BeamState>>(alloc<avector<BeamState>>());
+            arena_.reset();
+            beam_.assign(Parameter::PeriodCount+1,avector<BeamState>(alloc<BeamState>()));
+            //荷物とフィールドは複製せず、ステージのものを読む。ステージはInitからFinalizeまで変わらない
+            items_ = &aStage.items();
+            field_ = &aStage.field();
+
+            num_of_items_ = items_->count();
+            width_ = field_->width();
+            height_ = field_->height();
+            home_ = field_->officePos();
+            //距離はステージのフィールドの表に聞く。配達先と営業所への行はステージの生成時に作られている
             build_dtable();
+            const FieldDistance& table = field_->distances();
+            fill(dest_bits_,dest_bits_+table.cellCount(),0);
+            for(int i = 0; i < num_of_items_; ++i){
+                dest_cell_[i] = table.cellIndex((*items_)[i].destination());
+                dest_bits_[dest_cell_[i]] |= 1<<i;
+            }
+            home_cell_ = table.cellIndex(home_);
+            build_subset_costs();
 
         };
 
-        inline void think(const Stage& aStage, vector<vector<int>>* items_p, vector<vector<int>>* actions_p){
-            think(aStage,*items_p,*actions_p);
+        inline void think(const Stage& aStage,const MindSet& mind){
+            think(aStage,mind,WorkBudget());
         }
-        inline void think(const Stage& aStage, vector<vector<int>>& items, vector<vector<int>>& actions){
+        //仕事量はmindに渡す。守るかどうかはmind次第
+        inline void think(const Stage& aStage,const MindSet& mind,const WorkBudget& budget){
             init(aStage);
-            think_sequenses(items);
-            build_actions(items,actions);
+            plan_items_ = new_plan();
+            work_ = 0;
+            mind.think(*this,plan_items_,budget);
+            search_best_perm(plan_items_);
+            build_actions(plan_items_,plan_actions_);
         }
-     protected:
-        Pos home_;
-        Field field_;
-        int width_,height_;
-        ItemCollection items_;
-        int num_of_items_;
-
-        vector<vector<vector<int>>> dmap_to_items_;
-        vector<vector<int>> dmap_to_home_;
-        vector<vector<int>> dtable_;
-        vector<int> dtable_home_;
+        //次のinitまで有効
+        inline const Plan& plan_items() const{ return plan_items_; }
+        inline const ActionStream& plan_actions() const{ return plan_actions_; }
 
-        map<unsigned long,int> memo_;
-
-        inline void build_dmap(){
-            init_dmap();
-            calc_dmap();
-        };
+        //MindSetから使う計画の部品
+        inline Plan new_plan(){ return Plan(Parameter::PeriodCount,avector<int>(alloc()),alloc()); }
+        //時間帯の中を最小の順番で配ったときの燃料。積みきれない時間帯があればkHK_INF
+        inline int plan_cost(const Plan& items) const{
+            int cost = 0;
+            for(const auto& seq : items){
+                int mask = 0;
+                for(auto i : seq){ mask |= 1<<i; }
+                if(subset_cost_[mask]==kHK_INF) return kHK_INF;
+                cost += subset_cost_[mask];
+            }
+            return cost;
+        }
+        inline void random_clustering(Plan& items){
+            //cout << "!random_clustering" << endl;
+            avector<int> perm(num_of_items_,0,alloc());
+            iota(perm.begin(), perm.end(), 0);
+            constexpr unsigned seed = 114514;
+            shuffle(perm.begin(), perm.end(), default_random_engine(seed));
 
-        inline void init_dmap(){
-            dmap_to_items_ = 
-                vector<vector<vector<int>>>(num_of_items_,
-                    vector<vector<int>>(width_,
-                        vector<int>(height_,-1)));
-            dmap_to_home_ = vector<vector<int>>(width_,
-                        vector<int>(height_,-1));
-        };
+            int weights[4] = {0,0,0,0};
 
-        inline void calc_dmap(){
             for(int i = 0; i < num_of_items_; ++i){
-                Pos dest = items_[i].destination();
-                bfs_dmap(dmap_to_items_[i],dest.x,dest.y);
+                int id = perm[i];
+                int period = (*items_)[id].period();
+                if(period!=-1){
+                    items[period].push_back(id);
+                    weights[period]+=(*items_)[id].weight();
+                    perm[i]=-1;
+                }
             }
-            bfs_dmap(dmap_to_home_,home_.x,home_.y);
-        };
 
-        inline void bfs_dmap(vector<vector<int>>* dmap_p,int x_zero,int y_zero){
-            bfs_dmap(*dmap_p,x_zero,y_zero);
-        }
-        inline void bfs_dmap(vector<vector<int>>& dmap,int x_zero,int y_zero){
-            dmap[x_zero][y_zero] = 0;
-            queue<BFSQuery> ques;
-            ques.push({x_zero,y_zero,0});
-            while(!ques.empty()){
-                auto que = ques.front(); ques.pop();
-                int x = que.x, y = que.y, d = que.d;
-                for(int i = 0; i < 4; ++i){
-                    int nx = x+dxy[i*2], ny = y+dxy[i*2+1];
-                    if(within(0,nx,width_)&&within(0,ny,height_)){
-                        if((!field_.isWall(nx,ny))&&dmap[nx][ny]==-1){
-                            dmap[nx][ny]=d+1;
-                            ques.push({nx,ny,d+1});
+            int p=0;
+            for(int i : perm){
+                if(i!=-1){
+                    int w = (*items_)[i].weight();
+                    while(true){
+                        if(Parameter::TruckWeightCapacity<weights[p]+w){
+                            p = (p+1)%4;
+                            continue;
+                        }else{
+                            weights[p]+=w;
+                            items[p].push_back(i);
+                            p = (p+1)%4;
+                            break;
                         }
                     }
                 }
             }
-            return ;
-            for(auto& line : dmap){
-                for(auto& p : line){ cout << setfill(' ') << setw(3) << right << p; }
-                cout << endl;
-            }
         }
-
-        inline void build_dtable(){
-            init_dtable();
-            calc_dtable();
+        //時間帯ごとの順番の改善と、時間帯指定のない荷物の他の時間帯への移動を、良くなる手がなくなるまで繰り返す。
+        //試した手の数を仕事量に数え、使い切ったらそこまでの計画で止める
+        inline void local_search(Plan& items,const WorkBudget& budget){
+            Route routes[Parameter::PeriodCount];
+            for(int p = 0; p < Parameter::PeriodCount; ++p){ routes[p].assign(items[p],pdist_,pweight_); }
+            bool improved = true;
+            while(improved&&budget.allows(work_)){
+                improved = false;
+                for(auto& route : routes){
+                    while(budget.allows(work_)&&improve_route(route)){ improved = true; }
+                }
+                if(relocate(routes)) improved = true;
+            }
+            for(int p = 0; p < Parameter::PeriodCount; ++p){ routes[p].write(items[p]); }
         }
+        //全部の荷物を4つの時間帯に分ける、燃料の見積もりが最小の割り当てを求める。
+        //前半(0,1)と後半(2,3)の時間帯それぞれで、配る集合ごとの最小値を求めておき、
+        //互いに補集合になる組で最小のものを選ぶ。4つを順に重ねるより、調べる組み合わせがずっと少ない。
+        //itemsの計画を暫定解として始め、それより良ければ置き換える。最適な割り当てが求まればtrue。
+        //仕事量が前半の分しかなければ、前半の表で暫定解の時間帯0,1だけを最適に分け直す
+        inline bool partition(Plan& items,const WorkBudget& budget){
+            const int full = (1<<num_of_items_)-1;
+            if(!split_fixed()) return false;
+            if(!build_half(0,budget)) return false;
+            if(!build_half(2,budget)){
+                improve_front(items);
+                return false;
+            }
 
-        inline void init_dtable(){
-            dtable_ = vector<vector<int>>(num_of_items_,
-                vector<int>(num_of_items_,-1));
-            dtable_home_ = vector<int>(num_of_items_,-1);
-        };
-
-        inline void calc_dtable(){
-            int home_x = home_.x,home_y = home_.y;
-            for(int i = 0; i < num_of_items_; ++i){
-                const Pos& dest = items_[i].destination();
-                int dest_x = dest.x,dest_y = dest.y;
-                dtable_home_[i] = dmap_to_items_[i][home_x][home_y];
-                for(int j = 0; j < num_of_items_; ++j){
-                    int dist = dmap_to_items_[j][dest_x][dest_y];
-                    dtable_[i][j] = dist;
+            const vector<int>& front = part_cost_[1];
+            const vector<int>& back = part_cost_[Parameter::PeriodCount-1];
+            int best = kHK_INF,best_front = 0;
+            for(int mask = 0; mask <= full; ++mask){
+                if(front[mask]==kHK_INF||back[full^mask]==kHK_INF) continue;
+                if(front[mask]+back[full^mask]<best){
+                    best = front[mask]+back[full^mask];
+                    best_front = mask;
                 }
             }
-        };
-
-        inline void think_sequenses(vector<vector<int>>& items){
-            //cout << "!think_sequenses" << endl;
-            items = vector<vector<int>>(4,vector<int>(0));
-            //random_clustering(items);
-            clustering(items);
-            search_best_perm(items);
-        };
-        inline void search_best_perm(vector<vector<int>>& items){
-            for(auto& seq : items){
-                int loop_max = calc_loop_max(seq.size(),PINF);
-                int best_score = PINF;
-                vector<int> best_seq;
-                for(int i = 0; i < loop_max+1; ++i){
-                    next_permutation(seq.begin(),seq.end());
-                    int score = calc_score(seq);
-                    if(score<best_score){
-                        best_score = score;
-                        best_seq = seq;
-                    }
+            if(best==kHK_INF) return false;
+            //最適なので暫定解より悪くなることはない
+            int parts[Parameter::PeriodCount];
+            parts[1] = part_choice_[1][best_front];
+            parts[0] = best_front^parts[1];
+            parts[3] = part_choice_[3][full^best_front];
+            parts[2] = (full^best_front)^parts[3];
+            for(auto& seq : items){ seq.clear(); }
+            write_parts(parts,items);
+            return true;
+        }
+        //時間帯ごとに、配り終えた集合と燃料を状態として、燃料と残りの見積もりの和が小さいものからwidth個ずつ残して進める。
+        //残りの見積もりは、guideの計画で荷物ごとにかかっている燃料から求める。
+        //同じ集合になった状態は燃料の小さい方だけ残す。widthを大きくするほど遅くなるが、partitionの最適解に近づく。
+        //全部配り終えた状態が残らないか、仕事量の中で終わらなければfalse。
+        inline bool beam_search(Plan& items,const Plan& guide,int width,const WorkBudget& budget){
+            const int full = (1<<num_of_items_)-1;
+            if(!split_fixed()) return false;
+            set_beam_shares(guide);
+            beam_[0].clear();
+            beam_[0].push_back({0,0,remaining_estimate(full),-1,0});
+            for(int p = 0; p < Parameter::PeriodCount; ++p){
+                avector<BeamState>& next = beam_[p+1];
+                next.clear();
+                const int fixed = part_fixed_[p];
+                const int later = Parameter::TruckWeightCapacity*(Parameter::PeriodCount-1-p);
+                bool is_in_budget = true;
+                for(int s = 0; s < static_cast<int>(beam_[p].size())&&is_in_budget; ++s){
+                    const int done = beam_[p][s].done;
+                    const int avail = part_free_&~done;
+                    expand_beam(p,s,avail,fixed,full&~(done|avail|fixed),later);
+                    is_in_budget = budget.allows(work_);
+                }
+                for(const auto& state : next){ beam_slot_[state.done] = -1; }
+                if(!is_in_budget) return false;
+                if(width<static_cast<int>(next.size())){
+                    nth_element(next.begin(),next.begin()+width,next.end(),
+                        [](const BeamState& a,const BeamState& b){ return a.score<b.score; });
+                    next.resize(width);
                 }
-                seq = best_seq;
             }
+            //最後の時間帯は残りを全部配るので、残った状態はどれも配り終えている
+            const avector<BeamState>& last = beam_[Parameter::PeriodCount];
+            if(last.empty()) return false;
+            int best = 0;
+            for(int s = 1; s < static_cast<int>(last.size()); ++s){
+                if(last[s].cost<last[best].cost) best = s;
+            }
+            int parts[Parameter::PeriodCount];
+            for(int p = Parameter::PeriodCount; 0 < p; --p){
+                parts[p-1] = beam_[p][best].part;
+                best = beam_[p][best].parent;
+            }
+            write_parts(parts,items);
+            return true;
+        }
+        //時間帯指定のない荷物を1つずつ時間帯に割り当てる分枝限定法。itemsの計画を暫定解として始め、
+        //それより良い割り当てが見つかればitemsを置き換える。最適であると確かめられればtrue、
+        //仕事量を使い切って打ち切ったり、割り当てられなかったりすればfalse
+        inline bool branch_and_bound(Plan& items,const WorkBudget& budget){
+            if(!split_fixed()) return false;
+            bb_best_ = plan_cost(items);
+            bb_is_found_ = false;
+            bb_is_over_budget_ = false;
+            bb_budget_ = budget;
+            //燃料への影響が大きそうな荷物から決める
+            bb_free_count_ = 0;
+            for(int rest = part_free_; rest!=0; rest&=rest-1){ bb_order_[bb_free_count_++] = lowest_bit(rest); }
+            sort(bb_order_,bb_order_+bb_free_count_,[this](int a,int b){ return carry_bound(a)>carry_bound(b); });
+            bb_rest_carry_[bb_free_count_] = 0;
+            bb_rest_weight_[bb_free_count_] = 0;
+            for(int k = bb_free_count_-1; 0 <= k; --k){
+                bb_rest_carry_[k] = bb_rest_carry_[k+1]+carry_bound(bb_order_[k]);
+                bb_rest_weight_[k] = bb_rest_weight_[k+1]+(*items_)[bb_order_[k]].weight();
+            }
+            int cost = 0;
+            for(int p = 0; p < Parameter::PeriodCount; ++p){
+                bb_parts_[p] = part_fixed_[p];
+                cost += subset_cost_[part_fixed_[p]];
+            }
+            bb_search(0,cost);
+            if(bb_is_found_){
+                for(auto& seq : items){ seq.clear(); }
+                write_parts(bb_best_parts_,items);
+            }
+            return !bb_is_over_budget_&&bb_best_!=kHK_INF;
         }
-        inline void clustering(vector<vector<int>>& items){
-            vector<bitset<BITS>> period_clusters(4,bitset<BITS>());
-            vector<int> id;
-            vector<bitset<BITS>> clusters;
+        //まとめた荷物の塊ごとに時間帯を全通り試す。積載量に収まる分け方がなければfalse
+        inline bool clustering(Plan& items){
+            avector<bitset<BITS>> period_clusters(4,bitset<BITS>(),alloc<bitset<BITS>>());
+            avector<int> id(alloc());
+            avector<bitset<BITS>> clusters(alloc<bitset<BITS>>());
             calc_id_and_period_cluster(id,period_clusters);
             do_union_find(id,clusters);
             int clusters_size = clusters.size();
 
-            vector<int> pclusters_weight(4,0),clusters_weight(clusters_size,0);
+            avector<int> pclusters_weight(4,0,alloc()),clusters_weight(clusters_size,0,alloc());
             calc_weight(period_clusters,pclusters_weight);
             calc_weight(clusters,clusters_weight);
 
@@ -264,8 +641,8 @@ namespace {
             for(int i = 0; i < loops; ++i){
                 int score = 0;
                 bool valid = true;
-                vector<bitset<BITS>> diff(4,bitset<BITS>());
-                vector<int> diff_w(4,0);
+                bitset<BITS> diff[4];
+                int diff_w[4] = {0,0,0,0};
                 int num = i,divi = loops;
                 for(int j = 0; j < clusters_size; ++j){
                     divi/=4;
@@ -287,7 +664,8 @@ namespace {
                     best_i = i;
                 }
             }
-            vector<bitset<BITS>> diff(4,bitset<BITS>());
+            if(best_i==-1) return false;
+            bitset<BITS> diff[4];
             int num = best_i,divi = loops;
             for(int j = 0; j < clusters_size; ++j){
                 divi/=4;
@@ -303,44 +681,441 @@ namespace {
                 }
             }
             //cout << best_i << " " << best_score << endl;
+            return true;
         }
-        inline int get_best(const bitset<BITS>& bits){
-            unsigned long bits_id = bits.to_ulong();
-            if(memo_.count(bits_id)==1) return memo_[bits_id];
-            int seq_size = bits.count();
-            vector<int> seq(seq_size,0);
-            int j = 0;
+     protected:
+        Arena arena_;         //ステージごとの作業領域。initで捨てる
+        Plan plan_items_;     //時間帯ごとに配る荷物の順番
+        ActionStream plan_actions_;  //時間帯ごとの行動
+
+        template<class T = int> inline ArenaAllocator<T> alloc(){ return ArenaAllocator<T>(&arena_); }
+
+        Pos home_;
+        const Field* field_;  //ステージのフィールド。距離の表もステージで作ったものを読む
+        int width_,height_;
+        const ItemCollection* items_; //ステージの荷物
+        int num_of_items_;
+
+        int dest_bits_[FieldDistance::CellCountMax];  //マスを配達先とする荷物。添字は距離の表のマス番号
+        int dest_cell_[BITS];  //配達先のマス番号
+        int home_cell_;
+        int dtable_[BITS][BITS];
+        int dtable_home_[BITS];
+        uint16_t pdist_[kNODES*kNODES]; //[前の地点*kNODES+次の地点]の距離。Route用
+        int pweight_[kNODES];           //地点の荷物の重さ。営業所は0
+
+        //Held-Karp用
+        int hk_dist_[BITS][BITS];   //荷物どうしの距離
+        int hk_home_[BITS];         //営業所からの距離
+        vector<int> hk_dp_;         //[残りの集合*BITS+最初の荷物]の、そこから配り終えて戻るまでの最小燃料
+        vector<int> hk_weight_;     //集合の重さ
+        alignas(64) int subset_cost_[1<<BITS]; //集合を1つの時間帯で配る最小燃料。積めない集合はkHK_INF
+
+        //時間帯への割り当て用
+        vector<vector<int>> part_cost_;        //[時間帯][そこまでに配った集合]の最小燃料
+        vector<vector<uint16_t>> part_choice_; //そのとき最後の時間帯に配った集合
+        int part_fixed_[Parameter::PeriodCount]; //時間帯指定のある荷物
+        int part_free_;                          //時間帯指定のない荷物
+
+        //ビームサーチ用
+        struct BeamState{
+            int done;    //配り終えた集合
+            int cost;    //そこまでの燃料
+            int score;   //燃料と残りの見積もりの和。小さい方を残す
+            int parent;  //前の時間帯の状態の番号
+            int part;    //この時間帯に配った集合
+        };
+        avector<avector<BeamState>> beam_; //時間帯の始めごとの状態。Arenaに置く
+        vector<int> beam_slot_;                            //次の時間帯で集合がある状態の番号。なければ-1
+        int beam_share_[BITS];                             //荷物ごとの燃料の見積もり
+
+        //分枝限定法用
+        int bb_order_[BITS];                          //割り当てる順の時間帯指定のない荷物
+        int bb_free_count_;                           //時間帯指定のない荷物の数
+        int bb_rest_carry_[BITS+1];                   //bb_order_[k]から先のcarry_boundの和
+        int bb_rest_weight_[BITS+1];                  //bb_order_[k]から先の重さの和
+        int bb_parts_[Parameter::PeriodCount];        //今の割り当て
+        int bb_best_parts_[Parameter::PeriodCount];   //見つかった最良の割り当て
+        int bb_best_;                                 //その燃料。始めは暫定解の燃料
+        bool bb_is_found_;                            //暫定解より良い割り当てが見つかったか
+        bool bb_is_over_budget_;
+        WorkBudget bb_budget_;
+
+        long work_;  //thinkを始めてから調べた状態の数。WorkBudgetと比べる
+
+        inline void build_dtable(){
+            init_dtable();
+            calc_dtable();
+        }
+
+        inline void init_dtable(){
             for(int i = 0; i < BITS; ++i){
-                if(bits[i]){
-                    seq[j] = i;
-                    ++j;
+                fill(dtable_[i],dtable_[i]+BITS,-1);
+            }
+            fill(dtable_home_,dtable_home_+BITS,-1);
+        };
+
+        inline void calc_dtable(){
+            for(int i = 0; i < num_of_items_; ++i){
+                const Pos& dest = (*items_)[i].destination();
+                dtable_home_[i] = field_->distance(home_,dest);
+                for(int j = 0; j < num_of_items_; ++j){
+                    dtable_[i][j] = field_->distance((*items_)[j].destination(),dest);
                 }
             }
-            int loop_max = calc_loop_max(seq.size());
-            int best_score = calc_score(seq);
-            for(int i = 0; i < loop_max+1; ++i){
-                next_permutation(seq.begin(),seq.end());
-                int score = calc_score(seq);
-                if(score<best_score){
-                    best_score = score;
+            fill(pdist_,pdist_+kNODES*kNODES,0);
+            fill(pweight_,pweight_+kNODES,0);
+            for(int i = 0; i < num_of_items_; ++i){
+                pweight_[i] = (*items_)[i].weight();
+                pdist_[i*kNODES+kHOME_NODE] = pdist_[kHOME_NODE*kNODES+i] = dtable_home_[i];
+                for(int j = 0; j < num_of_items_; ++j){
+                    pdist_[i*kNODES+j] = dtable_[i][j];
+                }
+            }
+        };
+
+        //時間帯の中で燃料が減る手を1つ見つけたら適用してtrue
+        inline bool improve_route(Route& route){
+            const int n = route.size();
+            for(int i = 1; i <= n; ++i){
+                for(int j = i+1; j <= n; ++j){
+                    ++work_;
+                    if(route.delta_reverse(i,j)<0){ route.reverse(i,j); return true; }
+                    if(route.delta_swap(i,j)<0){ route.swap(i,j); return true; }
+                }
+            }
+            constexpr int kSEGMENT_MAX = 3; //Or-optで動かす荷物の数
+            int deltas[BITS+1];
+            for(int i = 1; i <= n; ++i){
+                for(int j = i; j < min(n+1,i+kSEGMENT_MAX); ++j){
+                    route.delta_moves(i,j,deltas);
+                    work_ += n-(j-i+1);
+                    for(int q = 0; q <= n; ++q){
+                        if(i-1<=q&&q<=j) continue;
+                        if(deltas[q]<0){ route.move(i,j,q); return true; }
+                    }
+                }
+            }
+            return false;
+        }
+        //時間帯指定のない荷物を、積載量に収まる他の時間帯へ移して燃料が減れば適用してtrue
+        inline bool relocate(Route* routes){
+            bool improved = false;
+            for(int a = 0; a < Parameter::PeriodCount; ++a){
+                for(int i = 1; i <= routes[a].size(); ++i){
+                    const int x = routes[a].node(i);
+                    if((*items_)[x].period()!=-1) continue;
+                    const int removed = routes[a].delta_remove(i);
+                    int best = 0,best_b = -1,best_q = -1;
+                    int deltas[BITS+1];
+                    for(int b = 0; b < Parameter::PeriodCount; ++b){
+                        if(b==a||Parameter::TruckWeightCapacity<routes[b].weight()+(*items_)[x].weight()) continue;
+                        routes[b].delta_inserts(x,deltas);
+                        work_ += routes[b].size()+1;
+                        for(int q = 0; q <= routes[b].size(); ++q){
+                            const int delta = removed+deltas[q];
+                            if(delta<best){ best = delta; best_b = b; best_q = q; }
+                        }
+                    }
+                    if(best_b!=-1){
+                        routes[a].remove(i);
+                        routes[best_b].insert(best_q,x);
+                        improved = true;
+                        --i;
+                    }
+                }
+            }
+            return improved;
+        }
+        inline void search_best_perm(Plan& items){
+            for(auto& seq : items){
+                int mask = 0;
+                for(auto i : seq){ mask |= 1<<i; }
+                best_order(mask,seq);
+            }
+        }
+        //時間帯指定のある荷物とない荷物を分ける。時間帯指定だけで積載量を超えるならfalse
+        inline bool split_fixed(){
+            for(int p = 0; p < Parameter::PeriodCount; ++p){ part_fixed_[p] = 0; }
+            part_free_ = 0;
+            for(int i = 0; i < num_of_items_; ++i){
+                int period = (*items_)[i].period();
+                if(period!=-1){
+                    part_fixed_[period] |= 1<<i;
+                }else{
+                    part_free_ |= 1<<i;
+                }
+            }
+            for(int p = 0; p < Parameter::PeriodCount; ++p){
+                if(Parameter::TruckWeightCapacity<hk_weight_[part_fixed_[p]]) return false;
+            }
+            return true;
+        }
+        inline void write_parts(const int* parts,Plan& items){
+            for(int p = 0; p < Parameter::PeriodCount; ++p){
+                for(int i = 0; i < num_of_items_; ++i){
+                    if(parts[p]&(1<<i)) items[p].push_back(i);
+                }
+            }
+        }
+        //荷物ごとの燃料の見積もりを、guideで配る時間帯の燃料を分けて求める。
+        //分ける比は、その荷物を外すと時間帯の燃料がどれだけ減るか。外しても燃料は増えないので比は正
+        inline void set_beam_shares(const Plan& guide){
+            fill(beam_share_,beam_share_+BITS,0);
+            for(const auto& seq : guide){
+                int mask = 0;
+                for(auto i : seq){ mask |= 1<<i; }
+                const long long cost = subset_cost_[mask];
+                if(cost==kHK_INF) continue;
+                long long saving[BITS],total = 0;
+                for(auto i : seq){
+                    saving[i] = cost-subset_cost_[mask^(1<<i)]+1;
+                    total += saving[i];
+                }
+                for(auto i : seq){ beam_share_[i] = static_cast<int>(cost*saving[i]/total); }
+            }
+        }
+        //restの荷物を配り終えるまでの燃料の見積もり
+        inline int remaining_estimate(int rest) const{
+            int estimate = 0;
+            for(; rest!=0; rest&=rest-1){ estimate += beam_share_[lowest_bit(rest)]; }
+            return estimate;
+        }
+        //beam_[p][s]から、時間帯pにavailの部分集合とpartを配る状態をbeam_[p+1]に足す。列挙の仕方はenum_partsと同じ
+        inline void expand_beam(int p,int s,int avail,int part,int left,int later){
+            ++work_;
+            if(later<hk_weight_[left]) return;
+            if(avail==0){
+                add_beam(p,s,part);
+                return;
+            }
+            const int bit = avail&(0-avail);
+            const int rest = avail^bit;
+            if(hk_weight_[part|bit]<=Parameter::TruckWeightCapacity) expand_beam(p,s,rest,part|bit,left,later);
+            expand_beam(p,s,rest,part,left|bit,later);
+        }
+        inline void add_beam(int p,int s,int part){
+            const int part_cost = subset_cost_[part];
+            if(part_cost==kHK_INF) return;
+            const BeamState& from = beam_[p][s];
+            const int done = from.done|part;
+            const int cost = from.cost+part_cost;
+            avector<BeamState>& next = beam_[p+1];
+            int& slot = beam_slot_[done];
+            if(slot==-1){
+                slot = next.size();
+                next.push_back({done,cost,cost+remaining_estimate(((1<<num_of_items_)-1)^done),s,part});
+            }else if(cost<next[slot].cost){
+                next[slot] = {done,cost,cost+remaining_estimate(((1<<num_of_items_)-1)^done),s,part};
+            }
+        }
+        //荷物iを足すと、どの時間帯に足しても少なくともこれだけ燃料が増える。
+        //足したあとの最適な経路からiを外せば、iを運ぶ分だけ安い、足す前の集合の経路になるため
+        inline int carry_bound(int i) const{ return (*items_)[i].weight()*dtable_home_[i]; }
+        //bb_order_[k]から先の荷物を割り当てる。costは今の割り当ての燃料
+        inline void bb_search(int k,int cost){
+            if(!bb_budget_.allows(++work_)) bb_is_over_budget_ = true;
+            if(bb_is_over_budget_) return;
+            if(k==bb_free_count_){
+                if(cost<bb_best_){
+                    bb_best_ = cost;
+                    copy(bb_parts_,bb_parts_+Parameter::PeriodCount,bb_best_parts_);
+                    bb_is_found_ = true;
+                }
+                return;
+            }
+            //残りの荷物は積める場所がなければならない
+            int room = 0;
+            for(int p = 0; p < Parameter::PeriodCount; ++p){ room += Parameter::TruckWeightCapacity-hk_weight_[bb_parts_[p]]; }
+            if(room<bb_rest_weight_[k]) return;
+            //下界: 今の燃料 + 残りの荷物それぞれのcarry_bound。
+            //さらに残りのうち1つは、実際に足したときの増え方の最小まで引き上げてよい(他の荷物はその後に足したとみなす)
+            int surplus = 0;
+            for(int t = k; t < bb_free_count_; ++t){
+                const int i = bb_order_[t];
+                int min_delta = kHK_INF;
+                for(int p = 0; p < Parameter::PeriodCount; ++p){
+                    const int next = bb_parts_[p]|(1<<i);
+                    if(Parameter::TruckWeightCapacity<hk_weight_[next]) continue;
+                    min_delta = min(min_delta,subset_cost_[next]-subset_cost_[bb_parts_[p]]);
+                }
+                if(min_delta==kHK_INF) return;
+                surplus = max(surplus,min_delta-carry_bound(i));
+            }
+            if(bb_best_<=cost+bb_rest_carry_[k]+surplus) return;
+
+            //増え方の小さい時間帯から試す。時間帯指定がなく空の時間帯はどれも同じなので、最初の1つだけ試す
+            const int i = bb_order_[k];
+            int periods[Parameter::PeriodCount],deltas[Parameter::PeriodCount],count = 0;
+            bool has_empty = false;
+            for(int p = 0; p < Parameter::PeriodCount; ++p){
+                const int next = bb_parts_[p]|(1<<i);
+                if(Parameter::TruckWeightCapacity<hk_weight_[next]) continue;
+                if(bb_parts_[p]==0&&part_fixed_[p]==0){
+                    if(has_empty) continue;
+                    has_empty = true;
                 }
+                const int delta = subset_cost_[next]-subset_cost_[bb_parts_[p]];
+                int c = count++;
+                for(; 0 < c&&delta<deltas[c-1]; --c){
+                    periods[c] = periods[c-1];
+                    deltas[c] = deltas[c-1];
+                }
+                periods[c] = p;
+                deltas[c] = delta;
+            }
+            for(int c = 0; c < count; ++c){
+                bb_parts_[periods[c]] |= 1<<i;
+                bb_search(k+1,cost+deltas[c]);
+                bb_parts_[periods[c]] ^= 1<<i;
+            }
+        }
+        //時間帯first,first+1で配る集合ごとの最小値をpart_cost_[first+1]に求める。
+        //それぞれの時間帯に配る集合は、時間帯指定を守り、積載量に収まるものだけを深さ優先で列挙する。
+        //仕事量を使い切ったらfalse。
+        inline bool build_half(int first,const WorkBudget& budget){
+            const int full = (1<<num_of_items_)-1;
+            //どちらも時間帯指定がなければ入れ替えても同じなので、先の時間帯に最小の荷物がある分け方だけを調べる
+            const bool is_symmetric = part_fixed_[first]==0&&part_fixed_[first+1]==0;
+            for(int p = first; p < first+2; ++p){
+                vector<int>& cost = part_cost_[p];
+                fill(cost.begin(),cost.begin()+full+1,kHK_INF);
+                const int fixed = part_fixed_[p];
+                //この時間帯より後に残る荷物を運べる重さ
+                const int later = Parameter::TruckWeightCapacity*(Parameter::PeriodCount-1-(p-first));
+                for(int done = 0; done <= full; ++done){
+                    if(!budget.allows(work_)) return false;
+                    const int base = p==first ? (done==0 ? 0 : kHK_INF) : part_cost_[p-1][done];
+                    if(base==kHK_INF) continue;
+                    int avail = part_free_&~done;
+                    if(p!=first&&is_symmetric) avail &= ~((done&(0-done))*2-1);
+                    enum_parts(p,done,base,avail,fixed,full&~(done|avail|fixed),later);
+                }
+            }
+            return true;
+        }
+        //availの部分集合にpartを足したもののうち、積載量に収まり、残りleftが後の時間帯に収まるものを列挙する
+        inline void enum_parts(int p,int done,int base,int avail,int part,int left,int later){
+            ++work_;
+            if(later<hk_weight_[left]) return;
+            if(avail==0){
+                add_part(p,done,base,part);
+                return;
+            }
+            const int bit = avail&(0-avail);
+            const int rest = avail^bit;
+            if(hk_weight_[part|bit]<=Parameter::TruckWeightCapacity) enum_parts(p,done,base,rest,part|bit,left,later);
+            enum_parts(p,done,base,rest,part,left|bit,later);
+        }
+        inline void add_part(int p,int done,int base,int part){
+            const int cost = subset_cost_[part];
+            if(cost==kHK_INF) return;
+            const int next = done|part;
+            if(base+cost<part_cost_[p][next]){
+                part_cost_[p][next] = base+cost;
+                part_choice_[p][next] = static_cast<uint16_t>(part);
+            }
+        }
+
+        //前半の表だけ求まったとき、itemsの時間帯0,1で配る荷物を、その2つの時間帯で最適に分け直す
+        inline void improve_front(Plan& items){
+            int masks[2] = {0,0};
+            for(int p = 0; p < 2; ++p){
+                for(auto i : items[p]){ masks[p] |= 1<<i; }
             }
-            memo_[bits_id] = best_score;
-            return best_score;
+            const int front = masks[0]|masks[1];
+            if(subset_cost_[masks[0]]+subset_cost_[masks[1]]<=part_cost_[1][front]) return;
+            const int second = part_choice_[1][front];
+            const int parts[2] = {front^second,second};
+            for(int p = 0; p < 2; ++p){
+                items[p].clear();
+                for(int i = 0; i < num_of_items_; ++i){
+                    if(parts[p]&(1<<i)) items[p].push_back(i);
+                }
+            }
+        }
+
+        inline int get_best(const bitset<BITS>& bits){
+            return subset_cost_[bits.to_ulong()];
         }
-        inline void calc_weight(const vector<bitset<BITS>>& clusters, vector<int>& weights){
+
+        //全部の集合について、その荷物を全部積んで営業所を出て、配り終えて戻るまでの最小の燃料(区間の距離×(トラック+積んでいる荷物)の重さの和)を求める。
+        //後ろから考えると、ある荷物から先の燃料は残りの集合だけで決まるので、
+        //(残りの集合,最初の荷物)ごとの最小値を小さい集合から順に求めれば、全集合の全順列を試したのと同じになる。
+        //積みきれない集合の部分集合は調べなくてよい。
+        inline void build_subset_costs(){
+            const int size = num_of_items_;
+            for(int a = 0; a < size; ++a){
+                hk_home_[a] = dtable_home_[a];
+                for(int b = 0; b < size; ++b){ hk_dist_[a][b] = dtable_[a][b]; }
+                for(int b = size; b < BITS; ++b){ hk_dist_[a][b] = 0; }
+            }
+            const int full = (1<<size)-1;
+            hk_weight_[0] = 0;
+            subset_cost_[0] = 0;
+            for(int mask = 1; mask <= full; ++mask){
+                hk_weight_[mask] = hk_weight_[mask&(mask-1)]+(*items_)[lowest_bit(mask)].weight();
+            }
+            for(int mask = 1; mask <= full; ++mask){
+                subset_cost_[mask] = kHK_INF;
+                if(Parameter::TruckWeightCapacity<hk_weight_[mask]) continue;
+                int* dp = &hk_dp_[mask*BITS];
+                for(int b = 0; b < BITS; ++b){ dp[b] = kHK_INF; }
+                int best = kHK_INF;
+                for(int rest = mask; rest!=0; rest&=rest-1){
+                    const int first = lowest_bit(rest);
+                    const int after = mask^(1<<first);
+                    if(after==0){
+                        dp[first] = hk_home_[first]*Parameter::TruckWeight;
+                    }else{
+                        //firstを配ったあとはafterを積んで次の荷物へ運ぶ
+                        const int carry = Parameter::TruckWeight+hk_weight_[after];
+                        const int* from = &hk_dp_[after*BITS];
+                        const int* dist = hk_dist_[first];
+                        //afterにない荷物はkHK_INFなので、区別せずに全部の最小値をとればよい
+                        int min_cost = kHK_INF;
+                        for(int b = 0; b < BITS; ++b){
+                            min_cost = min(min_cost,from[b]+dist[b]*carry);
+                        }
+                        dp[first] = min_cost;
+                    }
+                    best = min(best,dp[first]+hk_home_[first]*(Parameter::TruckWeight+hk_weight_[mask]));
+                }
+                subset_cost_[mask] = best;
+            }
+        }
+
+        //maskの荷物を最小の燃料で配る順番をseqに書き込む。積みきれない集合ならseqはそのまま
+        inline void best_order(int mask,avector<int>& seq){
+            if(subset_cost_[mask]==kHK_INF) return;
+            seq.clear();
+            int pos = -1; //-1は営業所
+            for(int rest = mask; rest!=0; rest^=1<<seq.back()){
+                const int carry = Parameter::TruckWeight+hk_weight_[rest];
+                int best = PINF,best_first = -1;
+                for(int bits = rest; bits!=0; bits&=bits-1){
+                    const int first = lowest_bit(bits);
+                    const int dist = pos==-1 ? hk_home_[first] : hk_dist_[pos][first];
+                    const int cost = dist*carry+hk_dp_[rest*BITS+first];
+                    if(cost<best){ best = cost; best_first = first; }
+                }
+                seq.push_back(best_first);
+                pos = best_first;
+            }
+        }
+        inline void calc_weight(const avector<bitset<BITS>>& clusters, avector<int>& weights){
             int clusters_size = clusters.size();
             for(int i = 0; i < clusters_size; ++i){
                 int w=0;
                 for(int j = 0; j < BITS; ++j){
-                    if(clusters[i][j]) w+=items_[j].weight();
+                    if(clusters[i][j]) w+=(*items_)[j].weight();
                 }
                 weights[i] = w;
             }
         }
-        inline void calc_id_and_period_cluster(vector<int>& id,vector<bitset<BITS>>& period_clusters){
+        inline void calc_id_and_period_cluster(avector<int>& id,avector<bitset<BITS>>& period_clusters){
             for(int i = 0; i < num_of_items_; ++i){
-                int period = items_[i].period();
+                int period = (*items_)[i].period();
                 bitset<BITS> item(0);
                 item[i] = true;
                 if(period!=-1){
@@ -350,10 +1125,10 @@ namespace {
                 }
             }
         }
-        inline void do_union_find(const vector<int>& id,vector<bitset<BITS>>& clusters,const int MAX_GROUPS=kMAX_GROUPS,const int MAX_WEIGHT=kMAX_WEIGHT){
+        inline void do_union_find(const avector<int>& id,avector<bitset<BITS>>& clusters,const int MAX_GROUPS=kMAX_GROUPS,const int MAX_WEIGHT=kMAX_WEIGHT){
             int id_size = id.size();
-            UnionFind uf(id_size);
-            priority_queue<UniteQuery> uqq;
+            UnionFind uf(id_size,alloc());
+            priority_queue<UniteQuery,avector<UniteQuery>> uqq(less<UniteQuery>(),avector<UniteQuery>(alloc<UniteQuery>()));
             for(int i = 0; i < id_size; ++i){
                 for(int j = i; j < id_size; ++j){
 
@@ -371,121 +1146,124 @@ namespace {
                 }
             }
             int p_cluster_size = uf.groups();
-            clusters = vector<bitset<BITS>>(p_cluster_size,bitset<BITS>());
-            map<int,int> root_to_cid;
+            clusters = avector<bitset<BITS>>(p_cluster_size,bitset<BITS>(),alloc<bitset<BITS>>());
+            avector<int> root_to_cid(id_size,-1,alloc()); //根ごとのクラスタ番号
             int roots_size = 0;
             for(int i = 0; i < id_size; ++i){
                 int r = uf.root(i);
-                if(root_to_cid.count(r)==0){
+                if(root_to_cid[r]==-1){
                     root_to_cid[r] = roots_size;
                     ++roots_size;
                 }
                 clusters[ root_to_cid[r] ][ id[i] ] = true;
             }
         }
-        inline void random_clustering(vector<vector<int>>& items){
-            //cout << "!random_clustering" << endl;
-            vector<int> perm(num_of_items_,0);
-            iota(perm.begin(), perm.end(), 0);
-            constexpr unsigned seed = 114514;
-            shuffle(perm.begin(), perm.end(), default_random_engine(seed));
-
-            vector<int> weights(4,0);
-
-            for(int i = 0; i < num_of_items_; ++i){
-                int id = perm[i];
-                int period = items_[id].period();
-                if(period!=-1){
-                    items[period].push_back(id);
-                    weights[period]+=items_[id].weight();
-                    perm[i]=-1;
-                }
-            }
 
-            int p=0;
-            for(int i : perm){
-                if(i!=-1){
-                    int w = items_[i].weight();
-                    while(true){
-                        if(Parameter::TruckWeightCapacity<weights[p]+w){
-                            p = (p+1)%4;
-                            continue;
-                        }else{
-                            weights[p]+=w;
-                            items[p].push_back(i);
-                            p = (p+1)%4;
-                            break;
-                        }
-                    }
+        inline void build_actions(const Plan& items,ActionStream& actions){
+            const FieldDistance& table = field_->distances();
+            actions.clear();
+            for(int period = 0; period < 4; ++period){
+                int cell = home_cell_;
+                //cout << "period :" << period << ", size :" << items[period].size() << endl;
+                auto& targets = items[period];
+                //途中で配達先を通った荷物はそこで降ろされるので、あとから向かわない
+                int passed = 0;
+                for(auto target : targets){
+                    if(passed&(1<<target)) continue;
+                    add_sequense(table,dest_cell_[target],cell,actions,passed);
                 }
+                add_sequense(table,home_cell_,cell,actions,passed);
+                actions.close_period();
             }
         }
 
-        inline int calc_loop_max(int size,int LOOP_MAX_MAX = kLOOP_MAX_MAX){
-            int ret = 1;
-            for(int i = 1; i < size; ++i){
-                ret*=(i+1);
-                if(LOOP_MAX_MAX<ret){
-                    ret = LOOP_MAX_MAX;
-                    break;
-                }
+        //次の一手の表をたどるだけ。距離を見比べる必要はない
+        inline void add_sequense(const FieldDistance& table,int to,int& cell,ActionStream& sequense,int& passed){
+            const uint8_t* next_actions = table.nextActions(to);
+            while(cell!=to){
+                const Action action = Action(next_actions[cell]);
+                sequense.push(action);
+                cell = table.neighbor(cell,action);
+                passed |= dest_bits_[cell];
             }
-            //cout << size << " " << ret << endl;
-            return ret;
         }
+    };
 
-        inline int calc_score(const vector<int>& seq){
-            int ret=0,last=-1;
-            int weight = 3;
-            for(auto i : seq){
-                weight+=items_[i].weight();
-            }
-            for(auto next : seq){
-                int dist;
-                if(last==-1){
-                    dist = dtable_home_[next];
-                }else{
-                    dist = dtable_[next][last];
-                }
-                last=next;
-                ret+=dist*weight;
-                weight-=items_[next].weight();
-            }
-
-            ret += dtable_home_[last]*weight;
-            return ret;
+    //時間帯への厳密な割り当て。まずすぐに作れる計画を局所探索で直しておき、仕事量の中で求まった分だけ置き換える
+    class ExactMind : public MindSet{
+     public:
+        const char* name() const override{ return "exact"; }
+        void think(Brain& brain,Plan& items,const WorkBudget& budget) const override{
+            brain.random_clustering(items);
+            brain.local_search(items,budget);
+            brain.partition(items,budget);
         }
-
-        inline void build_actions(const vector<vector<int>>& items,vector<vector<int>>& actions){
-            actions = vector<vector<int>>(4,vector<int>(0));
-            for(int period = 0; period < 4; ++period){
-                Pos pos = home_;
-                //cout << "period :" << period << ", size :" << items[period].size() << endl;
-                auto& targets = items[period];
-                for(auto target : targets){
-                    add_sequense(dmap_to_items_[target],pos,actions[period]);
-                }
-                add_sequense(dmap_to_home_,pos,actions[period]);
-            }
+    };
+    //適当に分けてから局所探索で直す
+    class LocalMind : public MindSet{
+     public:
+        const char* name() const override{ return "local"; }
+        void think(Brain& brain,Plan& items,const WorkBudget& budget) const override{
+            brain.random_clustering(items);
+            brain.local_search(items,budget);
         }
-
-        inline void add_sequense(const vector<vector<int>>& dmap_to_dest,Pos& pos,vector<int>& sequense){
-            int dist = dmap_to_dest[pos.x][pos.y];
-            while(dist!=0){
-                for(int i = 0; i < 4; ++i){
-                    int nx = pos.x+dxy[i*2], ny = pos.y+dxy[i*2+1];
-                    if(within(0,nx,width_)&&within(0,ny,height_)){
-                        if((dist-1)==dmap_to_dest[nx][ny]){
-                            dist = dmap_to_dest[nx][ny];
-                            sequense.push_back(i);
-                            pos=pos.move(Action(i));
-                            break;
-                        }
-                    }
-                }
+    };
+    //時間帯ごとに配った集合を状態とするビームサーチ。幅で速さと質を調整する。
+    //局所探索で直した計画を見積もりに使い、それより良くなったときだけ置き換える
+    class BeamMind : public MindSet{
+     public:
+        BeamMind(const char* name,int width):name_(name),width_(width){}
+        const char* name() const override{ return name_; }
+        void think(Brain& brain,Plan& items,const WorkBudget& budget) const override{
+            brain.random_clustering(items);
+            brain.local_search(items,budget);
+            Plan beam = brain.new_plan();
+            if(brain.beam_search(beam,items,width_,budget)&&brain.plan_cost(beam)<brain.plan_cost(items)) items = move(beam);
+        }
+     private:
+        const char* name_;
+        int width_;
+    };
+    //局所探索で直した計画を暫定解とする分枝限定法
+    class BranchAndBoundMind : public MindSet{
+     public:
+        const char* name() const override{ return "bnb"; }
+        void think(Brain& brain,Plan& items,const WorkBudget& budget) const override{
+            brain.random_clustering(items);
+            brain.local_search(items,budget);
+            brain.branch_and_bound(items,budget);
+        }
+    };
+    //近い荷物をまとめた塊ごとに時間帯を全通り試す(以前の解法)
+    class ClusterMind : public MindSet{
+     public:
+        const char* name() const override{ return "cluster"; }
+        void think(Brain& brain,Plan& items,const WorkBudget&) const override{
+            if(!brain.clustering(items)){
+                items = brain.new_plan();
+                brain.random_clustering(items);
             }
         }
     };
+    //適当に分けるだけ。比べるときの基準
+    class RandomMind : public MindSet{
+     public:
+        const char* name() const override{ return "random"; }
+        void think(Brain& brain,Plan& items,const WorkBudget&) const override{
+            brain.random_clustering(items);
+        }
+    };
+
+    //選べる解法。先頭が既定
+    const ExactMind exact_mind;
+    const BeamMind beam_mind("beam",kBEAM_WIDTH);
+    const BeamMind wide_beam_mind("beam-wide",kBEAM_WIDTH_WIDE);
+    const BranchAndBoundMind branch_and_bound_mind;
+    const LocalMind local_mind;
+    const ClusterMind cluster_mind;
+    const RandomMind random_mind;
+    const MindSet* const kMINDS[] = {&exact_mind,&beam_mind,&wide_beam_mind,&branch_and_bound_mind,&local_mind,&cluster_mind,&random_mind};
+    constexpr int kMIND_COUNT = sizeof(kMINDS)/sizeof(kMINDS[0]);
 }
 
 /// プロコン問題環境を表します。
@@ -497,20 +1275,19 @@ namespace hpc {
     /// ここで、各ステージに対して初期処理を行うことができます。
     ///
     /// @param[in] aStage 現在のステージ。
-    Brain smartest_brain;
-    vector<vector<int>> items;
-    vector<vector<int>> actions;
-    int period,turn,stage=-1;
+    // ステージを並列に実行する場合に備えて、解答の状態はスレッドごとに持つ。
+    thread_local Brain smartest_brain;
+    thread_local int period,turn,stage=-1;
+    // 解法は全スレッドで共通。ステージを実行していない間にだけ変える。
+    int mind_index = 0;
     //constexpr bool ISNOT_UNKO = true;
     void Answer::Init(const Stage& aStage){
         ++stage; //cout << "stage " << stage << endl;
-        smartest_brain.think(aStage,items,actions);
+        smartest_brain.think(aStage,*kMINDS[mind_index],work_schedule.budget(aStage.number()));
         period = -1;
         turn   = -1;
     }
 
-    void InitPeriod_old(const Stage& aStage, ItemGroup& aItemGroup);
-    Action GetNextAction_old(const Stage& aStage);
     //------------------------------------------------------------------------------
     /// 各配達時間帯開始時に呼び出されます。
     ///
@@ -524,9 +1301,22 @@ namespace hpc {
         ++period; //cout << "period : " << period << endl;
         turn=-1;
 
-        for(auto i : items[period]){ aItemGroup.addItem(i); }
-        return ;
-        //InitPeriod_old(aStage,aItemGroup);
+        for(auto i : smartest_brain.plan_items()[period]){ aItemGroup.addItem(i); }
+    }
+
+    //------------------------------------------------------------------------------
+    /// 各配達時間帯開始時、積み込みが終わった後に呼び出されます。
+    ///
+    /// ここで、この時間帯の行動をまとめて aActionPlan に設定することができます。
+    /// 設定した行動を使い切るまでは、GetNextAction は呼ばれません。
+    ///
+    /// @param[in] aStage 現在のステージ。
+    /// @param[in] aActionPlan この時間帯の行動計画。
+    void Answer::InitPeriodPlan(const Stage& aStage, ActionPlan& aActionPlan){
+        const ActionStream& actions = smartest_brain.plan_actions();
+        const int begin = actions.period_begin(period), end = actions.period_end(period);
+        for(int i = begin; i < end && !aActionPlan.isFull(); ++i){ aActionPlan.add(actions[i]); }
+        turn += end-begin;
     }
 
     //------------------------------------------------------------------------------
@@ -539,8 +1329,8 @@ namespace hpc {
         turn++; //cout << "turn : " << turn << endl;
         
         //cout << actions[period][turn] << endl;
-        return Action(actions[period][turn]);
-        //return GetNextAction_old(aStage);
+        const ActionStream& actions = smartest_brain.plan_actions();
+        return actions[actions.period_begin(period)+turn];
     }
 
     //------------------------------------------------------------------------------
@@ -576,39 +1366,32 @@ namespace hpc {
         }
     }
 
-    void InitPeriod_old(const Stage& aStage, ItemGroup& aItemGroup){
-        if (aStage.period() == 0) {
-            return;
-        }
-        for (int i = 0; i < aStage.items().count(); ++i) {
-            // まだ配達されてない荷物かどうか調べる
-            if (aStage.getTransportState(i) == TransportState_NotTransported) {
-                // 配達されてない荷物なので積み込む
-                aItemGroup.addItem(i);
-            }
-        }
+    //------------------------------------------------------------------------------
+    /// @return 選べる解法の数。
+    int Answer::StrategyCount()
+    {
+        return kMIND_COUNT;
     }
-/*
-    Action GetNextAction_old(const Stage& aStage){
-        static Random random; // デフォルトのシード値を使う
-        static Pos prev; // 初期値は重要ではない。(前のゲームの値が残っていても気にしない)
 
-        for (int retry = 0; ; ++retry) {
-            Action a = static_cast<Action>(random.randTerm(4));
-            Pos nextPos = aStage.truck().pos().move(a);
-            if (aStage.field().isWall(nextPos) == false) { // 動けるか
-                if (retry < 50 && nextPos == prev) {
-                    // 前にいた場所を避ける。
-                    // これで、同じような場所をウロウロしてなかなか進まないのを防げる。
-                    // ただし、50回やっても見つからないときは、諦める。
-                    continue;
-                }
-                prev = aStage.truck().pos();
-                return a;
-            }
-        }
+    //------------------------------------------------------------------------------
+    /// @return 解法の名前。
+    const char* Answer::StrategyName(int aIndex)
+    {
+        HPC_RANGE_ASSERT_MIN_UB_I(aIndex, 0, kMIND_COUNT);
+        return kMINDS[aIndex]->name();
+    }
+
+    //------------------------------------------------------------------------------
+    /// 以降のステージで使う解法を選びます。
+    ///
+    /// ステージの実行中には呼ばないでください。
+    ///
+    /// @param[in] aIndex 解法の番号。
+    void Answer::SelectStrategy(int aIndex)
+    {
+        HPC_RANGE_ASSERT_MIN_UB_I(aIndex, 0, kMIND_COUNT);
+        mind_index = aIndex;
     }
-*/
 }
 
 //------------------------------------------------------------------------------
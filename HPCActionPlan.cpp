@@ -0,0 +1,70 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief    HPCActionPlan.hpp の実装
+/// @author   ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+
+#include "HPCActionPlan.hpp"
+
+#include "HPCCommon.hpp"
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// クラスのインスタンスを生成します。
+    ActionPlan::ActionPlan()
+        : mActions()
+        , mCount(0)
+    {
+    }
+
+    //------------------------------------------------------------------------------
+    /// 計画を空にします。
+    void ActionPlan::reset()
+    {
+        mCount = 0;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 行動を末尾に追加します。
+    ///
+    /// @param[in] aAction 追加する行動。4方向のいずれかである必要があります。
+    void ActionPlan::add(Action aAction)
+    {
+        HPC_ENUM_ASSERT(Action, aAction);
+        HPC_RANGE_ASSERT_MIN_UB_I(mCount, 0, HPC_ARRAY_NUM(mActions));
+        mActions[mCount++] = aAction;
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return 行動の数。
+    int ActionPlan::count()const
+    {
+        return mCount;
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return これ以上行動を追加できない場合は @c true 。
+    bool ActionPlan::isFull()const
+    {
+        return mCount >= HPC_ARRAY_NUM(mActions);
+    }
+
+    //------------------------------------------------------------------------------
+    /// @param[in] aIndex 行動の番号。
+    ///
+    /// @return aIndex 番目の行動。
+    Action ActionPlan::operator[](int aIndex)const
+    {
+        HPC_RANGE_ASSERT_MIN_UB_I(aIndex, 0, mCount);
+        return mActions[aIndex];
+    }
+}
+
+//------------------------------------------------------------------------------
+// EOF
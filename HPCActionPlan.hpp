@@ -0,0 +1,40 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief    ActionPlan クラス
+/// @author   ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "HPCAction.hpp"
+#include "HPCParameter.hpp"
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// 配達時間帯の行動をまとめた計画を表します。
+    ///
+    /// 1ステージのターン数を超える行動は持てません。
+    class ActionPlan
+    {
+    public:
+        ActionPlan();
+
+        void reset();                           ///< 計画を空にします。
+        void add(Action aAction);               ///< 行動を末尾に追加します。
+
+        int count()const;                      ///< 行動の数を返します。
+        bool isFull()const;                    ///< これ以上行動を追加できないかどうかを返します。
+        Action operator[](int aIndex)const;    ///< 指定番号の行動を返します。
+
+    private:
+        Action mActions[Parameter::GameTurnPerStage];   ///< 行動
+        int mCount;                                     ///< 行動の数
+    };
+}
+//------------------------------------------------------------------------------
+// EOF
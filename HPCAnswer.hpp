@@ -11,6 +11,7 @@
 #pragma once
 
 #include "HPCAction.hpp"
+#include "HPCActionPlan.hpp"
 #include "HPCStage.hpp"
 
 namespace hpc {
@@ -26,10 +27,15 @@ namespace hpc {
 
         static void Init(const Stage& aStage);                                              ///< 各ステージ開始時に呼び出されます。
         static void InitPeriod(const Stage& aStage, ItemGroup& aItemGroup);                 ///< 各配達時間帯開始時に呼び出されます。
+        static void InitPeriodPlan(const Stage& aStage, ActionPlan& aActionPlan);           ///< 配達時間帯の行動をまとめて決定します。
         static Action GetNextAction(const Stage& aStage);                                   ///< 次の動作を決定します。
         static void FinalizePeriod(const Stage& aStage, StageState aStageState, int aCost); ///< 各配達時間帯終了時に呼び出されます。
         static void Finalize(const Stage& aStage, StageState aStageState, int aScore);      ///< 各ステージ終了時に呼び出されます。
 
+        static int StrategyCount();                                                         ///< 選べる解法の数を返します。
+        static const char* StrategyName(int aIndex);                                        ///< 解法の名前を返します。
+        static void SelectStrategy(int aIndex);                                             ///< 以降のステージで使う解法を選びます。
+
     private:
         Answer();
     };
@@ -0,0 +1,66 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief    HPCDeliveryPlan.hpp の実装
+/// @author   ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+
+#include "HPCDeliveryPlan.hpp"
+
+#include "HPCCommon.hpp"
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// クラスのインスタンスを生成します。
+    DeliveryPlan::DeliveryPlan()
+        : mItems()
+        , mCounts()
+    {
+    }
+
+    //------------------------------------------------------------------------------
+    /// 計画を空にします。
+    void DeliveryPlan::reset()
+    {
+        for (int i = 0; i < Parameter::PeriodCount; ++i) {
+            mCounts[i] = 0;
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// 指定時間帯の末尾に荷物を追加します。
+    ///
+    /// @param[in] aPeriod     配達時間帯。
+    /// @param[in] aItemIndex  荷物の番号。妥当かどうかは Stage::evaluatePlan で検査されます。
+    void DeliveryPlan::add(int aPeriod, int aItemIndex)
+    {
+        HPC_RANGE_ASSERT_MIN_UB_I(aPeriod, 0, Parameter::PeriodCount);
+        HPC_RANGE_ASSERT_MIN_UB_I(mCounts[aPeriod], 0, Parameter::ItemCountMax);
+        mItems[aPeriod][mCounts[aPeriod]++] = aItemIndex;
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return 指定時間帯の荷物の数。
+    int DeliveryPlan::count(int aPeriod)const
+    {
+        HPC_RANGE_ASSERT_MIN_UB_I(aPeriod, 0, Parameter::PeriodCount);
+        return mCounts[aPeriod];
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return 指定時間帯で aIndex 番目に配達する荷物の番号。
+    int DeliveryPlan::item(int aPeriod, int aIndex)const
+    {
+        HPC_RANGE_ASSERT_MIN_UB_I(aPeriod, 0, Parameter::PeriodCount);
+        HPC_RANGE_ASSERT_MIN_UB_I(aIndex, 0, mCounts[aPeriod]);
+        return mItems[aPeriod][aIndex];
+    }
+}
+
+//------------------------------------------------------------------------------
+// EOF
@@ -0,0 +1,39 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief    DeliveryPlan クラス
+/// @author   ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "HPCParameter.hpp"
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// ステージ全体の配達計画を表します。
+    ///
+    /// 配達時間帯ごとに、積み込む荷物を配達する順番に並べて持ちます。
+    /// どの時間帯の並びに入っているかが、その荷物を配達する時間帯になります。
+    class DeliveryPlan
+    {
+    public:
+        DeliveryPlan();
+
+        void reset();                               ///< 計画を空にします。
+        void add(int aPeriod, int aItemIndex);      ///< 指定時間帯の末尾に荷物を追加します。
+
+        int count(int aPeriod)const;                ///< 指定時間帯の荷物の数を返します。
+        int item(int aPeriod, int aIndex)const;     ///< 指定時間帯で aIndex 番目に配達する荷物を返します。
+
+    private:
+        int mItems[Parameter::PeriodCount][Parameter::ItemCountMax];   ///< 配達する荷物の番号
+        int mCounts[Parameter::PeriodCount];                           ///< 荷物の数
+    };
+}
+//------------------------------------------------------------------------------
+// EOF
@@ -0,0 +1,289 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief    HPCFastStage.hpp の実装
+/// @author   ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+
+#include "HPCFastStage.hpp"
+
+#include "HPCCommon.hpp"
+#include "HPCStage.hpp"
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// クラスのインスタンスを生成します。
+    FastStage::FastStage()
+        : mWidth(0)
+        , mOfficeCell(0)
+        , mMoveOffsets()
+        , mWalls()
+        , mDestinationItems()
+        , mWeights()
+        , mLowWeights()
+        , mHighWeights()
+        , mAllBits(0)
+        , mPeriodBits()
+        , mFixedBits(0)
+        , mScoreBase(0)
+        , mCell(0)
+        , mLoadBits(0)
+        , mLoadWeight(0)
+        , mTransportingBits(0)
+        , mTransportedBits(0)
+        , mPeriod(0)
+        , mPeriodCost(0)
+        , mTotalCost(0)
+        , mTurnIndex(0)
+        , mState(StageState_TERM)
+        , mTurnResult()
+    {
+    }
+
+    //------------------------------------------------------------------------------
+    /// ステージのフィールドと荷物を、マスの番号とビットマスクの表に変換して取り込みます。
+    ///
+    /// @param[in] aStage  取り込むステージ。
+    void FastStage::setup(const Stage& aStage)
+    {
+        const Field& field = aStage.field();
+        const ItemCollection& items = aStage.items();
+
+        mWidth = field.width();
+        mOfficeCell = field.officePos().y * mWidth + field.officePos().x;
+        mMoveOffsets[Action_MoveLeft] = -1;
+        mMoveOffsets[Action_MoveRight] = 1;
+        mMoveOffsets[Action_MoveDown] = -mWidth;
+        mMoveOffsets[Action_MoveUp] = mWidth;
+        for (int y = 0; y < field.height(); ++y) {
+            for (int x = 0; x < mWidth; ++x) {
+                mWalls[y * mWidth + x] = field.isWall(x, y);
+                mDestinationItems[y * mWidth + x] = -1;
+            }
+        }
+
+        mAllBits = 0;
+        mFixedBits = 0;
+        for (int p = 0; p < Parameter::PeriodCount; ++p) {
+            mPeriodBits[p] = 0;
+        }
+        for (int i = 0; i < items.count(); ++i) {
+            const Item& item = items[i];
+            mDestinationItems[item.destination().y * mWidth + item.destination().x] = i;
+            mWeights[i] = item.weight();
+            mAllBits |= 1 << i;
+            if (item.period() >= 0) {
+                mPeriodBits[item.period()] |= 1 << i;
+                mFixedBits |= 1 << i;
+            }
+        }
+        for (int i = items.count(); i < Parameter::ItemCountMax; ++i) {
+            mWeights[i] = 0;
+        }
+
+        // 集合の重さを、半分ずつの表を引いて求められるようにする。
+        const int halfCount = Parameter::ItemCountMax / 2;
+        for (int bits = 0; bits < (1 << halfCount); ++bits) {
+            mLowWeights[bits] = 0;
+            mHighWeights[bits] = 0;
+            for (int i = 0; i < halfCount; ++i) {
+                if (bits & (1 << i)) {
+                    mLowWeights[bits] += mWeights[i];
+                    mHighWeights[bits] += mWeights[halfCount + i];
+                }
+            }
+        }
+        mScoreBase = field.width() * field.height() * items.count() * 10000;
+    }
+
+    //------------------------------------------------------------------------------
+    /// ステージを開始します。 Stage::start と同じ初期状態の TurnResult が記録されます。
+    void FastStage::start()
+    {
+        mCell = mOfficeCell;
+        mLoadBits = 0;
+        mLoadWeight = 0;
+        mTransportingBits = 0;
+        mTransportedBits = 0;
+        mPeriod = -1;
+        mPeriodCost = 0;
+        mTotalCost = 0;
+        mTurnIndex = 0;
+        mState = StageState_Playing;
+
+        mTurnResult.state = mState;
+        mTurnResult.initPeriod = false;
+        mTurnResult.action = Action_TERM;
+        mTurnResult.truckPos = Pos(mCell % mWidth, mCell / mWidth);
+        mTurnResult.itemGroup.setBits(mLoadBits);
+        mTurnResult.periodCost = mPeriodCost;
+        mTurnResult.totalCost = mTotalCost;
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return トラックが空で営業所にいる場合は @c true 。
+    bool FastStage::isLoadTurn()const
+    {
+        return mLoadBits == 0 && mCell == mOfficeCell;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 積み込みのターンを1つ進めます。
+    ///
+    /// @param[in] aItemGroup  積み込む荷物。
+    void FastStage::runTurn(const ItemGroup& aItemGroup)
+    {
+        HPC_ASSERT(mState == StageState_Playing);
+        HPC_ASSERT(isLoadTurn());
+        ++mPeriod;
+        mPeriodCost = 0;
+
+        const int itemBits = aItemGroup.getBits();
+        if (!isValidLoad(itemBits)) {
+            // Stage と同じく、ターン番号は進めずに終了する。
+            mState = StageState_Failed;
+            mTurnResult.state = mState;
+            mTurnResult.initPeriod = true;
+            mTurnResult.action = Action_TERM;
+            mTurnResult.truckPos = Pos(mCell % mWidth, mCell / mWidth);
+            mTurnResult.itemGroup.setBits(mLoadBits);
+            mTurnResult.periodCost = mPeriodCost;
+            mTurnResult.totalCost = mTotalCost;
+            return;
+        }
+
+        mLoadBits = itemBits;
+        mTransportingBits = itemBits;
+        mLoadWeight = weight(itemBits);
+        endTurn(true, Action_TERM);
+    }
+
+    //------------------------------------------------------------------------------
+    /// 配達のターンを1つ進めます。
+    ///
+    /// @param[in] aAction  トラックの行動。
+    void FastStage::runTurn(Action aAction)
+    {
+        HPC_ASSERT(mState == StageState_Playing);
+        HPC_ASSERT(!isLoadTurn());
+        HPC_ENUM_ASSERT(Action, aAction);
+        mPeriodCost += Parameter::TruckWeight + mLoadWeight;
+        const int nextCell = mCell + mMoveOffsets[aAction];
+        if (!mWalls[nextCell]) {
+            mCell = nextCell;
+            const int item = mDestinationItems[nextCell];
+            if (item >= 0 && (mLoadBits & (1 << item))) {
+                mLoadBits &= ~(1 << item);
+                mLoadWeight -= mWeights[item];
+            }
+        }
+        endTurn(false, aAction);
+    }
+
+    //------------------------------------------------------------------------------
+    const TurnResult& FastStage::lastTurnResult()const
+    {
+        return mTurnResult;
+    }
+
+    //------------------------------------------------------------------------------
+    StageState FastStage::state()const
+    {
+        return mState;
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return 配達が完了していればスコア。そうでなければ 0 。
+    int FastStage::score()const
+    {
+        if (mState == StageState_Complete) {
+            return mScoreBase / mTotalCost;
+        }
+        return 0;
+    }
+
+    //------------------------------------------------------------------------------
+    /// @param[in] aItemBits  荷物の集合。存在しない荷物は含まない必要があります。
+    /// @return 荷物の重さの合計。
+    int FastStage::weight(int aItemBits)const
+    {
+        const int halfCount = Parameter::ItemCountMax / 2;
+        const int halfMask = (1 << halfCount) - 1;
+        return mLowWeights[aItemBits & halfMask] + mHighWeights[(aItemBits >> halfCount) & halfMask];
+    }
+
+    //------------------------------------------------------------------------------
+    /// Stage::runTurn の積み込みの検査を、ビット演算でまとめて行います。
+    ///
+    /// @param[in] aItemBits  積み込む荷物。
+    /// @return 妥当なら @c true 。
+    bool FastStage::isValidLoad(int aItemBits)const
+    {
+        const int itemMask = (1 << Parameter::ItemCountMax) - 1;
+        const int deliveredBits = mTransportedBits | mTransportingBits;
+        if (aItemBits & itemMask & ~mAllBits) {
+            // 存在しない荷物を積み込もうとした。
+            return false;
+        }
+        if (aItemBits & deliveredBits) {
+            // 配達済みの荷物を積み込もうとした。
+            return false;
+        }
+        if (aItemBits & mFixedBits & ~mPeriodBits[mPeriod]) {
+            // この時間帯に配達すべきではない荷物を積み込んだ。
+            return false;
+        }
+        if (mPeriodBits[mPeriod] & ~aItemBits) {
+            // この時間帯に配達すべき荷物を積み込まなかった。
+            return false;
+        }
+        if (mPeriod == Parameter::PeriodCount - 1 && (mAllBits & ~deliveredBits & ~aItemBits)) {
+            // 最後の時間帯なのに、残りの荷物をすべて積み込まなかった。
+            return false;
+        }
+        if (weight(aItemBits) > Parameter::TruckWeightCapacity) {
+            // 最大積載重量を超えて積み込んだ。
+            return false;
+        }
+        return true;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 結果を保存し、時間帯とターンの終了処理を行います。
+    ///
+    /// 結果の燃料は、 Stage と同じく時間帯の終了処理の前の値です。
+    void FastStage::endTurn(bool aInitPeriod, Action aAction)
+    {
+        mTurnResult.initPeriod = aInitPeriod;
+        mTurnResult.action = aAction;
+        mTurnResult.truckPos = Pos(mCell % mWidth, mCell / mWidth);
+        mTurnResult.itemGroup.setBits(mLoadBits);
+        mTurnResult.periodCost = mPeriodCost;
+        mTurnResult.totalCost = mTotalCost;
+
+        if (isLoadTurn()) {
+            // トラックが空であり、かつ営業所にいるので、この配達時間帯を終了する。
+            mTotalCost += mPeriodCost;
+            mTransportedBits |= mTransportingBits;
+            mTransportingBits = 0;
+            if (mPeriod == Parameter::PeriodCount - 1) {
+                mState = StageState_Complete;
+            }
+        }
+
+        // ターン数が一定数を超えたら終了
+        ++mTurnIndex;
+        if (mState == StageState_Playing && mTurnIndex >= Parameter::GameTurnPerStage) {
+            mState = StageState_TurnLimit;
+        }
+        mTurnResult.state = mState;
+    }
+}
+
+//------------------------------------------------------------------------------
+// EOF
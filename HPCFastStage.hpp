@@ -0,0 +1,81 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief    FastStage クラス
+/// @author   ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "HPCAction.hpp"
+#include "HPCItemGroup.hpp"
+#include "HPCParameter.hpp"
+#include "HPCStageState.hpp"
+#include "HPCTurnResult.hpp"
+
+namespace hpc {
+
+    class Stage;
+
+    //------------------------------------------------------------------------------
+    /// Stage と同じ規則でターンを進める、高速な実装です。
+    ///
+    /// マスを1次元の番号で、荷物の集合をビットマスクで扱い、
+    /// 積み込みの検査もビット演算で行います。
+    /// Answer は呼ばないので、積み込む荷物と行動は呼び出し側が与えます。
+    /// 結果は lastTurnResult で、 Stage と同じ内容の TurnResult として得られます。
+    class FastStage
+    {
+    public:
+        FastStage();
+
+        void setup(const Stage& aStage);                    ///< ステージのフィールドと荷物を取り込みます。
+
+        void start();                                       ///< ステージを開始します。
+        bool isLoadTurn()const;                             ///< 次のターンが積み込みかどうかを返します。
+        void runTurn(const ItemGroup& aItemGroup);          ///< 積み込みのターンを1つ進めます。
+        void runTurn(Action aAction);                       ///< 配達のターンを1つ進めます。
+        const TurnResult& lastTurnResult()const;            ///< 最後のターン実行後の結果を返します。
+        StageState state()const;                            ///< 現在の状態を返します。
+        int score()const;                                   ///< スコアを返します。
+
+    private:
+        static const int CellCount = Parameter::FieldHeightMax * Parameter::FieldWidthMax;
+
+        int weight(int aItemBits)const;                     ///< 荷物の重さの合計を返します。
+        bool isValidLoad(int aItemBits)const;               ///< 積み込む荷物が妥当かどうかを返します。
+        void endTurn(bool aInitPeriod, Action aAction);     ///< ターンの終了処理を行います。
+
+        // ステージ開始後は変化しない情報
+        int mWidth;                                         ///< フィールドの幅
+        int mOfficeCell;                                    ///< 営業所のマス
+        int mMoveOffsets[Action_TERM];                      ///< 各行動で移動するマスの番号の差
+        bool mWalls[CellCount];                             ///< マスごとの壁
+        int mDestinationItems[CellCount];                   ///< マスごとの、そこを配達先とする荷物番号。なければ -1。
+        int mWeights[Parameter::ItemCountMax];              ///< 荷物の重さ
+        int mLowWeights[1 << (Parameter::ItemCountMax / 2)];    ///< 荷物番号の下位半分の集合ごとの、重さの合計
+        int mHighWeights[1 << (Parameter::ItemCountMax / 2)];   ///< 荷物番号の上位半分の集合ごとの、重さの合計
+        int mAllBits;                                       ///< 存在する荷物
+        int mPeriodBits[Parameter::PeriodCount];            ///< 時間帯ごとの、その時間帯が指定された荷物
+        int mFixedBits;                                     ///< 時間帯が指定された荷物
+        int mScoreBase;                                     ///< スコア計算用の、幅 × 高さ × 荷物数 × 10000
+
+        // 進行に伴って変化する状態
+        int mCell;                                          ///< トラックのマス
+        int mLoadBits;                                      ///< トラックに積まれている荷物
+        int mLoadWeight;                                    ///< トラックに積まれている荷物の重さの合計
+        int mTransportingBits;                              ///< 今の時間帯に配達する荷物
+        int mTransportedBits;                               ///< 前の時間帯までに配達済みの荷物
+        int mPeriod;                                        ///< 配達時間帯
+        int mPeriodCost;                                    ///< この時間帯に消費した燃料
+        int mTotalCost;                                     ///< この時間帯までに消費した燃料
+        int mTurnIndex;                                     ///< 現在のターン番号
+        StageState mState;                                  ///< 現在の状態
+        TurnResult mTurnResult;                             ///< ターンの実行結果
+    };
+}
+//------------------------------------------------------------------------------
+// EOF
@@ -11,6 +11,8 @@
 
 #include "HPCField.hpp"
 
+#include "HPCFieldDistance.hpp"
+
 namespace hpc {
     //------------------------------------------------------------------------------
     /// クラスのインスタンスを生成します。
@@ -18,6 +20,40 @@ namespace hpc {
         : mWidth(0)
         , mHeight(0)
         , mWalls()
+        , mDistances()
+        , mIsDistancesReady(false)
+    {
+    }
+
+    //------------------------------------------------------------------------------
+    /// 壁を複製したインスタンスを生成します。
+    ///
+    /// 距離の表は複製元と共有しません。必要なら buildDistances で作ってください。
+    Field::Field(const Field& aField)
+        : mWidth(0)
+        , mHeight(0)
+        , mWalls()
+        , mDistances()
+        , mIsDistancesReady(false)
+    {
+        set(aField);
+    }
+
+    //------------------------------------------------------------------------------
+    /// 壁を複製します。
+    ///
+    /// 距離の表は複製元と共有しません。すでに表があれば、領域を使い回して buildDistances で作り直します。
+    Field& Field::operator=(const Field& aField)
+    {
+        set(aField);
+        return *this;
+    }
+
+    //------------------------------------------------------------------------------
+    /// インスタンスを破棄します。
+    ///
+    /// FieldDistance はここで完全な型になっている必要があるので、ヘッダーでは定義しません。
+    Field::~Field()
     {
     }
 
@@ -31,6 +67,7 @@ namespace hpc {
         HPC_ASSERT(aHeight % 4 == 3);
         mWidth = aWidth;
         mHeight = aHeight;
+        mIsDistancesReady = false;
         for (int i = 0; i < mHeight; ++i) {
             for (int j = 0; j < mWidth; ++j) {
                 mWalls[i][j] = Parameter::PeriodAllMask;
@@ -86,6 +123,7 @@ namespace hpc {
                 mWalls[i][j] = aField.mWalls[i][j];
             }
         }
+        mIsDistancesReady = false;
     }
 
     //------------------------------------------------------------------------------
@@ -129,6 +167,102 @@ namespace hpc {
     {
         return Pos((mWidth - 1) / 2, (mHeight - 1) / 2);
     }
+
+    //------------------------------------------------------------------------------
+    /// @param[in] aFrom  出発する位置。通路であること。
+    /// @param[in] aTo    行き先。通路であること。
+    ///
+    /// @return 最短距離。たどり着けなければ -1 。
+    int Field::distance(const Pos& aFrom, const Pos& aTo) const
+    {
+        const FieldDistance& table = distances();
+        const int from = table.cellIndex(aFrom);
+        const int to = table.cellIndex(aTo);
+        HPC_ASSERT(from >= 0 && to >= 0);
+        return table.distance(from, to);
+    }
+
+    //------------------------------------------------------------------------------
+    /// 最短の行動が複数ある場合は、 Action の順で最初のものを返します。
+    ///
+    /// @param[in] aFrom  出発する位置。通路であること。
+    /// @param[in] aTo    行き先。 aFrom と異なり、 aFrom からたどり着けること。
+    ///
+    /// @return aFrom から aTo へ最短で向かう最初の行動。
+    Action Field::nextAction(const Pos& aFrom, const Pos& aTo) const
+    {
+        const FieldDistance& table = distances();
+        const int from = table.cellIndex(aFrom);
+        const int to = table.cellIndex(aTo);
+        HPC_ASSERT(from >= 0 && to >= 0);
+        return table.nextAction(from, to);
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return 壁を変えてから buildDistances か buildAllDistances を呼んでいれば @c true 。
+    bool Field::hasDistances() const
+    {
+        return mIsDistancesReady;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 最短距離の表を返します。
+    ///
+    /// 問い合わせられるのは、 buildDistances で指定した行き先か、 buildAllDistances の後なら全てのマスです。
+    ///
+    /// @return 最短距離の表。
+    const FieldDistance& Field::distances() const
+    {
+        HPC_ASSERT_MSG(mIsDistancesReady, "Field distances are not built.");
+        return *mDistances;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 指定した行き先への最短距離を求めておきます。
+    ///
+    /// 前に求めた表は捨てます。行き先は少ないので、呼び出したスレッドで順に求めます。
+    ///
+    /// @param[in] aTargets      行き先の位置の配列。通路であること。
+    /// @param[in] aTargetCount  行き先の数。
+    void Field::buildDistances(const Pos* aTargets, int aTargetCount)
+    {
+        FieldDistance& table = prepareDistances();
+        int targets[FieldDistance::CellCountMax];
+        for (int i = 0; i < aTargetCount; ++i) {
+            targets[i] = table.cellIndex(aTargets[i]);
+            HPC_ASSERT(targets[i] >= 0);
+        }
+        table.build(targets, aTargetCount, 1);
+        mIsDistancesReady = true;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 全ての組の最短距離を求めておきます。
+    ///
+    /// 多くの組を問い合わせる解析などで、先にまとめて求めておくために使います。
+    ///
+    /// @param[in] aThreadCount スレッド数。0 の場合はハードウェアの並列数を使います。
+    void Field::buildAllDistances(int aThreadCount)
+    {
+        prepareDistances().buildAll(aThreadCount);
+        mIsDistancesReady = true;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 今の壁に合わせてマスに番号を振った、行のない表を用意します。
+    ///
+    /// 前に作った表があれば、その領域を使い回します。
+    ///
+    /// @return 用意した表。
+    FieldDistance& Field::prepareDistances()
+    {
+        if (!mDistances) {
+            mDistances.reset(new FieldDistance());
+        }
+        mDistances->setup(*this);
+        mIsDistancesReady = false;
+        return *mDistances;
+    }
 }
 //------------------------------------------------------------------------------
 // EOF
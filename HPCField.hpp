@@ -11,6 +11,9 @@
 #pragma once
 
 //------------------------------------------------------------------------------
+#include <memory>
+
+#include "HPCAction.hpp"
 #include "HPCCommon.hpp"
 #include "HPCParameter.hpp"
 #include "HPCPos.hpp"
@@ -18,12 +21,25 @@
 
 namespace hpc {
 
+    class FieldDistance;
+
     //------------------------------------------------------------------------------
     /// 矩形のフィールドを表します。
+    ///
+    /// 通路のマスどうしの最短距離は、 buildDistances で FieldDistance の表を作っておき、
+    /// const な関数で問い合わせます。問い合わせは表を読むだけなので、複数のスレッドから同時に呼べます。
+    /// ステージの Field は LevelDesigner::Setup が営業所と配達先への表を作るので、
+    /// Answer はステージの Field をそのまま問い合わせてください。
+    ///
+    /// 距離の表は Field ごとに持ち、複製しても共有しません。
+    /// set や setup で壁が変わっても表の領域は使い回し、 buildDistances で中身だけを作り直します。
     class Field
     {
     public:
         Field();
+        Field(const Field& aField);             ///< 壁を複製します。距離の表は複製しません。
+        Field& operator=(const Field& aField);  ///< 壁を複製します。距離の表は複製しません。
+        ~Field();
 
         /// フィールドを生成する。
         /// @param[in]      aWidth   フィールドの幅
@@ -42,10 +58,21 @@ namespace hpc {
 
         Pos officePos() const;        ///< 営業所の位置取得。
 
+        int distance(const Pos& aFrom, const Pos& aTo) const;      ///< 2点間の最短距離。たどり着けなければ -1 。
+        Action nextAction(const Pos& aFrom, const Pos& aTo) const; ///< aFrom から aTo へ最短で向かう最初の行動。
+        bool hasDistances() const;                                  ///< 今の壁に合わせた最短距離の表があるかどうか。
+        const FieldDistance& distances() const;                     ///< 最短距離の表。
+        void buildDistances(const Pos* aTargets, int aTargetCount); ///< 指定した行き先への最短距離を求めておきます。
+        void buildAllDistances(int aThreadCount);                   ///< 全ての組の最短距離を並列に求めておきます。
+
     private:
         int mWidth;
         int mHeight;
         int mWalls[Parameter::FieldHeightMax][Parameter::FieldWidthMax];
+        std::unique_ptr<FieldDistance> mDistances; ///< 最短距離の表。はじめて作るまでは空
+        bool mIsDistancesReady;                    ///< mDistances が今の壁に合わせて作られているかどうか
+
+        FieldDistance& prepareDistances();         ///< 今の壁に合わせて、行のない表を用意します。
     };
 }
 //------------------------------------------------------------------------------
@@ -0,0 +1,261 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief    HPCFieldDistance.hpp の実装
+/// @author   ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+
+#include "HPCFieldDistance.hpp"
+
+#include <thread>
+#include <vector>
+
+#include "HPCCommon.hpp"
+#include "HPCField.hpp"
+#include "HPCMath.hpp"
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// クラスのインスタンスを生成します。
+    FieldDistance::FieldDistance()
+        : mCellCount(0)
+        , mCellIndices()
+        , mCellPos()
+        , mNeighbors()
+        , mDistances()
+        , mNextActions()
+        , mIsBuilt()
+        , mCapacity(0)
+    {
+    }
+
+    //------------------------------------------------------------------------------
+    /// 通路のマスに番号を振り、隣り合うマスを求めます。
+    ///
+    /// 距離の表は領域を確保するだけで、中身は build か buildAll で作ります。
+    /// 前の setup で確保した領域に収まる場合は、確保し直さずに使い回します。
+    ///
+    /// @param[in] aField  フィールド情報。
+    void FieldDistance::setup(const Field& aField)
+    {
+        mCellCount = 0;
+        for (int y = 0; y < Parameter::FieldHeightMax; ++y) {
+            for (int x = 0; x < Parameter::FieldWidthMax; ++x) {
+                mCellIndices[y][x] = -1;
+            }
+        }
+        for (int y = 0; y < aField.height(); ++y) {
+            for (int x = 0; x < aField.width(); ++x) {
+                if (!aField.isWall(x, y)) {
+                    mCellPos[mCellCount] = Pos(x, y);
+                    mCellIndices[y][x] = mCellCount;
+                    ++mCellCount;
+                }
+            }
+        }
+        for (int cell = 0; cell < mCellCount; ++cell) {
+            for (int a = 0; a < Action_TERM; ++a) {
+                const Pos next = mCellPos[cell].move(static_cast<Action>(a));
+                const bool isInField = 0 <= next.x && next.x < aField.width() && 0 <= next.y && next.y < aField.height();
+                mNeighbors[cell][a] = isInField ? mCellIndices[next.y][next.x] : -1;
+            }
+        }
+
+        if (mCellCount > mCapacity) {
+            mCapacity = mCellCount;
+            mDistances.reset(new uint16_t[mCapacity * mCapacity]);
+            mNextActions.reset(new uint8_t[mCapacity * mCapacity]);
+            mIsBuilt.reset(new bool[mCapacity]);
+        }
+        for (int cell = 0; cell < mCellCount; ++cell) {
+            mIsBuilt[cell] = false;
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// 指定した行き先の行を作ります。作ってある行はそのままです。
+    ///
+    /// 行き先ごとに独立しているので、スレッド数が2以上なら行き先を分けて複数スレッドで作ります。
+    /// 1 なら呼び出したスレッドで順に作ります。
+    ///
+    /// @param[in] aTargets      行き先のマスの番号の配列。 nullptr なら全てのマス。
+    /// @param[in] aTargetCount  行き先の数。
+    /// @param[in] aThreadCount  スレッド数。0 の場合はハードウェアの並列数を使います。
+    void FieldDistance::build(const int* aTargets, int aTargetCount, int aThreadCount)
+    {
+        int threadCount = aThreadCount;
+        if (threadCount <= 0) {
+            threadCount = Math::Max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+        }
+        threadCount = Math::Min(threadCount, Math::Max(aTargetCount, 1));
+        auto work = [this, aTargets, aTargetCount, threadCount](int aWorker) {
+            for (int i = aWorker; i < aTargetCount; i += threadCount) {
+                const int to = aTargets != nullptr ? aTargets[i] : i;
+                HPC_RANGE_ASSERT_MIN_UB_I(to, 0, mCellCount);
+                if (!mIsBuilt[to]) {
+                    buildRow(to);
+                }
+            }
+        };
+        if (threadCount == 1) {
+            work(0);
+            return;
+        }
+        std::vector<std::thread> threads;
+        for (int worker = 0; worker < threadCount; ++worker) {
+            threads.push_back(std::thread(work, worker));
+        }
+        for (std::size_t i = 0; i < threads.size(); ++i) {
+            threads[i].join();
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// 全ての行き先の行を作ります。
+    ///
+    /// @param[in] aThreadCount スレッド数。0 の場合はハードウェアの並列数を使います。
+    void FieldDistance::buildAll(int aThreadCount)
+    {
+        build(nullptr, mCellCount, aThreadCount);
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return 通路のマスの数。
+    int FieldDistance::cellCount()const
+    {
+        return mCellCount;
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return 指定位置のマスの番号。壁なら -1 。
+    int FieldDistance::cellIndex(const Pos& aPos)const
+    {
+        HPC_RANGE_ASSERT_MIN_UB_I(aPos.x, 0, Parameter::FieldWidthMax);
+        HPC_RANGE_ASSERT_MIN_UB_I(aPos.y, 0, Parameter::FieldHeightMax);
+        return mCellIndices[aPos.y][aPos.x];
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return マスの位置。
+    Pos FieldDistance::cellPos(int aCell)const
+    {
+        HPC_RANGE_ASSERT_MIN_UB_I(aCell, 0, mCellCount);
+        return mCellPos[aCell];
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return aCell から aAction で移動した先のマスの番号。壁なら -1 。
+    int FieldDistance::neighbor(int aCell, Action aAction)const
+    {
+        HPC_RANGE_ASSERT_MIN_UB_I(aCell, 0, mCellCount);
+        HPC_ENUM_ASSERT(Action, aAction);
+        return mNeighbors[aCell][aAction];
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return aTo を行き先とする行を build か buildAll で作ってあれば @c true 。
+    bool FieldDistance::hasRow(int aTo)const
+    {
+        HPC_RANGE_ASSERT_MIN_UB_I(aTo, 0, mCellCount);
+        return mIsBuilt[aTo];
+    }
+
+    //------------------------------------------------------------------------------
+    /// 行き先の行を返します。
+    ///
+    /// @param[in] aTo  行き先のマス。行を作ってある必要があります。
+    ///
+    /// @return マスの番号ごとの aTo までの距離。たどり着けないマスは Unreachable 。
+    const uint16_t* FieldDistance::row(int aTo)const
+    {
+        HPC_ASSERT_MSG(hasRow(aTo), "Distance row of cell %d is not built.", aTo);
+        return &mDistances[aTo * mCellCount];
+    }
+
+    //------------------------------------------------------------------------------
+    /// 行き先へ向かう次の一手の行を返します。
+    ///
+    /// @param[in] aTo  行き先のマス。行を作ってある必要があります。
+    ///
+    /// @return マスの番号ごとの aTo へ最短で向かう最初の行動。 aTo 自身とたどり着けないマスは Action_TERM 。
+    const uint8_t* FieldDistance::nextActions(int aTo)const
+    {
+        HPC_ASSERT_MSG(hasRow(aTo), "Distance row of cell %d is not built.", aTo);
+        return &mNextActions[aTo * mCellCount];
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return 2つのマスの最短距離。たどり着けなければ -1 。
+    int FieldDistance::distance(int aFrom, int aTo)const
+    {
+        HPC_RANGE_ASSERT_MIN_UB_I(aFrom, 0, mCellCount);
+        const uint16_t distance = row(aTo)[aFrom];
+        return distance == Unreachable ? -1 : distance;
+    }
+
+    //------------------------------------------------------------------------------
+    /// aFrom から aTo へ最短で向かうときの最初の行動を返します。
+    ///
+    /// 最短の行動が複数ある場合は、 Action の順で最初のものを返します。
+    ///
+    /// @pre aFrom と aTo は異なり、 aFrom から aTo へたどり着けること。
+    Action FieldDistance::nextAction(int aFrom, int aTo)const
+    {
+        HPC_RANGE_ASSERT_MIN_UB_I(aFrom, 0, mCellCount);
+        const Action action = static_cast<Action>(nextActions(aTo)[aFrom]);
+        HPC_ENUM_ASSERT(Action, action);
+        return action;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 行き先 aTo から幅優先探索をして、距離と次の一手の行を作ります。
+    ///
+    /// 次の一手は、距離が1つ小さい隣のマスのうち Action の順で最初のものです。
+    void FieldDistance::buildRow(int aTo)
+    {
+        uint16_t* distances = &mDistances[aTo * mCellCount];
+        for (int cell = 0; cell < mCellCount; ++cell) {
+            distances[cell] = Unreachable;
+        }
+        int queue[CellCountMax];
+        int tail = 0;
+        distances[aTo] = 0;
+        queue[tail++] = aTo;
+        for (int head = 0; head < tail; ++head) {
+            const int cell = queue[head];
+            const uint16_t distance = distances[cell] + 1;
+            for (int a = 0; a < Action_TERM; ++a) {
+                const int next = mNeighbors[cell][a];
+                if (next >= 0 && distances[next] == Unreachable) {
+                    distances[next] = distance;
+                    queue[tail++] = next;
+                }
+            }
+        }
+
+        // たどり着けるマスは全てキューに積まれているので、積まれた順に次の一手を決める。
+        uint8_t* nextActions = &mNextActions[aTo * mCellCount];
+        for (int cell = 0; cell < mCellCount; ++cell) {
+            nextActions[cell] = Action_TERM;
+        }
+        for (int head = 1; head < tail; ++head) {
+            const int cell = queue[head];
+            for (int a = 0; a < Action_TERM; ++a) {
+                const int next = mNeighbors[cell][a];
+                if (next >= 0 && distances[next] + 1 == distances[cell]) {
+                    nextActions[cell] = static_cast<uint8_t>(a);
+                    break;
+                }
+            }
+        }
+        mIsBuilt[aTo] = true;
+    }
+}
+
+//------------------------------------------------------------------------------
+// EOF
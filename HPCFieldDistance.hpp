@@ -0,0 +1,76 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief    FieldDistance クラス
+/// @author   ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "HPCAction.hpp"
+#include "HPCParameter.hpp"
+#include "HPCPos.hpp"
+
+namespace hpc {
+
+    class Field;
+
+    //------------------------------------------------------------------------------
+    /// フィールドの通路のマスどうしの最短距離を表します。
+    ///
+    /// 通路のマスに詰めた番号を振り、全ての組の距離を 16 ビットの表で持ちます。
+    /// 31x31 のフィールドでも通路は 961 マス以下なので、表は 2MB 以下に収まります。
+    /// 表は行き先ごとの行に分かれていて、 build で指定した行き先の行だけを幅優先探索で作ります。
+    /// 全ての行が必要な場合は buildAll で並列に作ることができます。
+    /// 問い合わせは表を読むだけなので、作り終えた表は複数のスレッドから同時に問い合わせることができます。
+    ///
+    /// 距離は対称なので、行き先の行を見れば、全てのマスからその行き先までの距離がわかります。
+    ///
+    /// 行を作るときに、各マスから行き先へ向かう最初の行動(次の一手)の表も同じ形で作ります。
+    /// 経路をたどるときは、次の一手を引いて隣のマスへ進むことを繰り返すだけで済みます。
+    class FieldDistance
+    {
+    public:
+        /// 通路のマスの最大数。
+        static const int CellCountMax = Parameter::FieldWidthMax * Parameter::FieldHeightMax;
+        /// たどり着けないマスの距離。
+        static const uint16_t Unreachable = 0xFFFF;
+
+        FieldDistance();
+
+        void setup(const Field& aField);                    ///< 通路のマスに番号を振ります。表はまだ作りません。
+        void build(const int* aTargets, int aTargetCount, int aThreadCount); ///< 指定した行き先の行を作ります。
+        void buildAll(int aThreadCount);                    ///< 全ての行を並列に作ります。
+
+        int cellCount()const;                               ///< 通路のマスの数。
+        int cellIndex(const Pos& aPos)const;                ///< 指定位置のマスの番号。壁なら -1 。
+        Pos cellPos(int aCell)const;                        ///< マスの位置。
+        int neighbor(int aCell, Action aAction)const;       ///< 行動した先のマスの番号。壁なら -1 。
+
+        bool hasRow(int aTo)const;                          ///< aTo の行を作ってあるかどうか。
+        const uint16_t* row(int aTo)const;                  ///< 全てのマスから aTo までの距離。
+        const uint8_t* nextActions(int aTo)const;           ///< 全てのマスから aTo へ向かう次の一手。
+        int distance(int aFrom, int aTo)const;              ///< 2つのマスの最短距離。たどり着けなければ -1 。
+        Action nextAction(int aFrom, int aTo)const;         ///< aFrom から aTo へ最短で向かう最初の行動。
+
+    private:
+        void buildRow(int aTo);
+
+        int mCellCount;                                                         ///< 通路のマスの数
+        int mCellIndices[Parameter::FieldHeightMax][Parameter::FieldWidthMax];  ///< 位置ごとのマスの番号
+        Pos mCellPos[CellCountMax];                                             ///< マスの位置
+        int mNeighbors[CellCountMax][Action_TERM];                              ///< 行動ごとの隣のマス。壁なら -1
+        std::unique_ptr<uint16_t[]> mDistances;                                 ///< [行き先 * mCellCount + 出発] の距離
+        std::unique_ptr<uint8_t[]> mNextActions;                                ///< [行き先 * mCellCount + 出発] の次の一手
+        std::unique_ptr<bool[]> mIsBuilt;                                       ///< 行き先ごとの行を作ったか
+        int mCapacity;                                                          ///< 表の領域を確保してあるマスの数
+    };
+}
+//------------------------------------------------------------------------------
+// EOF
@@ -25,6 +25,7 @@ namespace hpc {
         , mStage()
         , mCurrentStageIndex(0)
         , mRecord()
+        , mCheckpoint()
     {
     }
 
@@ -32,30 +33,91 @@ namespace hpc {
     /// 現在指定されているステージを開始します。
     ///
     /// @pre 現在のステージ番号が有効な範囲内にある必要があります。
+    ///
+    /// @tparam TRecordPolicy 記録方針。
+    template <class TRecordPolicy>
     void Game::startStage(bool aIsInTime)
     {
         HPC_ASSERT_MSG(isValidStage(), "Index indicates an invalid Stage (#%d)", mCurrentStageIndex);
 
         // ステージの生成を行います。
-        LevelDesigner::Setup(mCurrentStageIndex, mStage, mRandom);
+        setupStage(mCurrentStageIndex, mStage);
 
         mStage.start(aIsInTime);
-        mRecord.writeStartStage(mCurrentStageIndex, mStage);
-        mRecord.writeTurn(mStage.lastTurnResult());
+        if (TRecordPolicy::IsStageRecorded) {
+            mRecord.writeStartStage(mCurrentStageIndex, mStage);
+        }
+        if (TRecordPolicy::IsTurnRecorded) {
+            mRecord.writeTurn(mStage.lastTurnResult());
+        }
+    }
+
+    template void Game::startStage<FullRecordPolicy>(bool aIsInTime);
+    template void Game::startStage<SummaryRecordPolicy>(bool aIsInTime);
+    template void Game::startStage<NoRecordPolicy>(bool aIsInTime);
+
+    //------------------------------------------------------------------------------
+    /// ゲームの乱数を使って、次のステージを指定のステージに生成します。
+    ///
+    /// 後から任意のステージを直接生成できるように、開始時点の乱数を控えておきます。
+    /// ステージの実行とは別のスレッドで、先にステージを生成しておく場合にも使います。
+    ///
+    /// @pre ステージ番号は 0 から順番に指定する必要があります。
+    ///
+    /// @param[in]  aStageIndex ステージ番号。
+    /// @param[out] aStage      生成先のステージ。
+    void Game::setupStage(int aStageIndex, Stage& aStage)
+    {
+        mCheckpoint.write(aStageIndex, mRandom);
+        LevelDesigner::Setup(aStageIndex, aStage, mRandom);
     }
 
     //------------------------------------------------------------------------------
     /// 現ステージの1ターンをターン実行します。
     ///
+    /// 配達時間帯の行動計画が設定されている場合も、進めるのは1ターンだけです。
+    /// デバッガのように1ターンずつ進めたい場合に使います。
+    /// 計画をまとめて実行するには、続けて runPlannedTurns() を呼んでください。
+    ///
     /// @pre 事前に startStage() が呼ばれ、現在のステージが実行中の状態である必要があります。
+    ///
+    /// @tparam TRecordPolicy 記録方針。
+    template <class TRecordPolicy>
     void Game::runTurn()
     {
         HPC_ASSERT_MSG(isValidStage(), "Index indicates an invalid Stage (#%d)", mCurrentStageIndex);
 
-        mStage.runTurn();
-        mRecord.writeTurn(mStage.lastTurnResult());
+        mStage.runTurn<TRecordPolicy>();
+        if (TRecordPolicy::IsTurnRecorded) {
+            mRecord.writeTurn(mStage.lastTurnResult());
+        }
     }
 
+    template void Game::runTurn<FullRecordPolicy>();
+    template void Game::runTurn<SummaryRecordPolicy>();
+    template void Game::runTurn<NoRecordPolicy>();
+
+    //------------------------------------------------------------------------------
+    /// 現ステージで、配達時間帯の行動計画が残っている間、ターンをまとめて実行します。
+    ///
+    /// 制限時間はターンごとに確かめます。詳しくは Stage::runPlannedTurns を参照してください。
+    ///
+    /// @pre 事前に startStage() が呼ばれている必要があります。
+    ///
+    /// @tparam TRecordPolicy 記録方針。
+    /// @param[in] aTimer ゲームタイマー。
+    template <class TRecordPolicy>
+    void Game::runPlannedTurns(const Timer& aTimer)
+    {
+        HPC_ASSERT_MSG(isValidStage(), "Index indicates an invalid Stage (#%d)", mCurrentStageIndex);
+
+        mStage.runPlannedTurns<TRecordPolicy>(aTimer, &mRecord.stage(mCurrentStageIndex));
+    }
+
+    template void Game::runPlannedTurns<FullRecordPolicy>(const Timer& aTimer);
+    template void Game::runPlannedTurns<SummaryRecordPolicy>(const Timer& aTimer);
+    template void Game::runPlannedTurns<NoRecordPolicy>(const Timer& aTimer);
+
     //------------------------------------------------------------------------------
     /// 現ステージ内における進行状況を表す値を取得します。
     ///
@@ -63,7 +125,19 @@ namespace hpc {
     StageState Game::state()const
     {
         HPC_ASSERT_MSG(isValidStage(), "Index indicates an invalid Stage (#%d)", mCurrentStageIndex);
-        return mStage.lastTurnResult().state;
+        return mStage.state();
+    }
+
+    //------------------------------------------------------------------------------
+    /// 現在のステージのスコアを返します。
+    ///
+    /// 記録を行わない場合に、ステージ終了時のスコアを得るために使います。
+    ///
+    /// @return 現在のステージのスコア。完了していない場合は 0 。
+    int Game::stageScore()const
+    {
+        HPC_ASSERT_MSG(isValidStage(), "Index indicates an invalid Stage (#%d)", mCurrentStageIndex);
+        return mStage.score();
     }
 
     //------------------------------------------------------------------------------
@@ -72,13 +146,22 @@ namespace hpc {
     /// @attention この関数を呼ぶと、ステージのインデックスが 1 追加されます。
     ///            そのため、最後のステージではステージ番号が無効になります。
     ///            ステージ開始前に、必ず isValidStage() 関数を利用してステージが有効かどうかを確認する必要があります。
+    ///
+    /// @tparam TRecordPolicy 記録方針。
+    template <class TRecordPolicy>
     void Game::onStageDone()
     {
         HPC_ASSERT_MSG(isValidStage(), "Index indicates an invalid Stage (#%d)", mCurrentStageIndex);
-        mRecord.writeEndStage(mStage);
+        if (TRecordPolicy::IsStageRecorded) {
+            mRecord.writeEndStage(mStage);
+        }
         ++mCurrentStageIndex;
     }
 
+    template void Game::onStageDone<FullRecordPolicy>();
+    template void Game::onStageDone<SummaryRecordPolicy>();
+    template void Game::onStageDone<NoRecordPolicy>();
+
     //------------------------------------------------------------------------------
     /// 内部で示されるステージ番号が有効な範囲を指しているかどうかを取得します。
     ///
@@ -100,6 +183,39 @@ namespace hpc {
     {
         return mRecord;
     }
+
+    //------------------------------------------------------------------------------
+    /// 内部に格納されているゲームの記録を返します。
+    ///
+    /// @return ゲームの記録を表す @c Record クラスへの参照を返します。
+    Record& Game::record()
+    {
+        return mRecord;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 全ステージを生成して、各ステージ開始時点の乱数を求めます。
+    ///
+    /// ステージを順番に実行せずに任意のステージから始める場合に、事前に呼び出します。
+    /// 乱数は進まないので、この後に順番に実行しても同じステージが生成されます。
+    ///
+    /// @pre まだステージを1つも開始していない必要があります。
+    void Game::buildCheckpoint()
+    {
+        HPC_ASSERT(mCurrentStageIndex == 0);
+        mCheckpoint.build(mRandom);
+    }
+
+    //------------------------------------------------------------------------------
+    /// 各ステージ開始時点の乱数を返します。
+    ///
+    /// ステージを順番に実行した場合は、開始済みのステージの分が記録されています。
+    ///
+    /// @return 各ステージ開始時点の乱数を表す @c StageCheckpoint クラスへの const 参照を返します。
+    const StageCheckpoint& Game::checkpoint()const
+    {
+        return mCheckpoint;
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -13,7 +13,9 @@
 #include "HPCParameter.hpp"
 #include "HPCRandom.hpp"
 #include "HPCRecord.hpp"
+#include "HPCRecordPolicy.hpp"
 #include "HPCStage.hpp"
+#include "HPCStageCheckpoint.hpp"
 
 namespace hpc {
 
@@ -24,19 +26,35 @@ namespace hpc {
     public:
         Game(Random& aRandom);
 
+        /// @name ステージの実行
+        /// テンプレート引数の記録方針に従って記録します。同じステージでは同じ方針を指定する必要があります。
+        //@{
+        template <class TRecordPolicy = FullRecordPolicy>
         void startStage(bool aIsInTime);   ///< 現在のステージを開始します。
+        template <class TRecordPolicy = FullRecordPolicy>
         void runTurn();                     ///< 現在実行中のステージでターンを1つ進めます。
-        StageState state()const;           ///< ステージ内での現在の状態を表します。
+        template <class TRecordPolicy = FullRecordPolicy>
+        void runPlannedTurns(const Timer& aTimer); ///< 行動計画が残っている間、ターンを続けて進めます。
+        template <class TRecordPolicy = FullRecordPolicy>
         void onStageDone();                 ///< ステージ終了を通知します。
+        //@}
+        void setupStage(int aStageIndex, Stage& aStage);   ///< 次のステージを生成します。
+        StageState state()const;           ///< ステージ内での現在の状態を表します。
+        int stageScore()const;             ///< 現在のステージのスコアを返します。
         bool isValidStage()const;          ///< 現在のステージが有効なものかどうかを返します。
 
         const Record& record()const;       ///< 記録へのアクセサ
+        Record& record();                   ///< 記録へのアクセサ
+
+        void buildCheckpoint();                         ///< 全ステージ開始時点の乱数を求めます。
+        const StageCheckpoint& checkpoint()const;      ///< 各ステージ開始時点の乱数へのアクセサ
 
     private:
         Random& mRandom;                    ///< 乱数生成
         Stage mStage;                       ///< ステージ
         int mCurrentStageIndex;             ///< 現在のステージ番号
         Record mRecord;                     ///< 記録
+        StageCheckpoint mCheckpoint;        ///< 各ステージ開始時点の乱数
     };
 }
 //------------------------------------------------------------------------------
@@ -31,17 +31,15 @@ namespace hpc {
         int height = Parameter::FieldHeightMin;
         height += aRandom.randTerm((Parameter::FieldHeightMax - Parameter::FieldHeightMin) / 4 + 1) * 4;
 
-        // ステージ番号から、壁密度、時間帯指定されている荷物の割合、荷物数を決める。
+        // ステージ番号から、壁密度、時間帯指定されている荷物の数、荷物数を決める。
+        aStage.setNumber(aNumber);
         int wallDensityIndex = aNumber % Parameter::WallDensityMax;
-        int periodSpecifiedIndex = (aNumber / Parameter::WallDensityMax) % Parameter::PeriodSpecifiedMax;
-        int itemCountIndex = (aNumber / (Parameter::WallDensityMax * Parameter::PeriodSpecifiedMax)) % Parameter::ItemCountMax;
 
         // wallDensity は 0 にはならないようにする。あまりにも壁がない迷路になるため。
         int wallDensity = (wallDensityIndex + 1) * (100 / Parameter::WallDensityMax);
 
-        // 時間帯指定されている荷物の個数。割合がそのまま適用される。端数は切り捨て。
-        int itemCount = itemCountIndex + 1;
-        int periodSpecifiedCount = itemCount * periodSpecifiedIndex / (Parameter::PeriodSpecifiedMax - 1);
+        int itemCount = ItemCount(aNumber);
+        int periodSpecifiedCount = PeriodSpecifiedCount(aNumber);
 
         // フィールド生成
         aStage.field().setup(width, height, wallDensity, aRandom);
@@ -104,6 +102,48 @@ namespace hpc {
             }
             aStage.items().addItem(pos, periodSpecs[i], itemWeights[i]);
         }
+
+        // 営業所と配達先への最短距離を、ステージごとに1回だけ求めておく。
+        // Answer や配達計画の評価は、この表を読むだけで済む。
+        Pos targets[Parameter::ItemCountMax + 1];
+        targets[0] = aStage.field().officePos();
+        for (int i = 0; i < itemCount; ++i) {
+            targets[i + 1] = aStage.items()[i].destination();
+        }
+        aStage.field().buildDistances(targets, itemCount + 1);
+        for (int i = 0; i < itemCount; ++i) {
+            // 迷路は営業所から掘っているので、通路ならどこでも営業所から行ける。
+            HPC_ASSERT(aStage.field().distance(aStage.field().officePos(), targets[i + 1]) >= 0);
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// ステージ番号から、そのステージの荷物数を求めます。
+    ///
+    /// @note ステージを生成せずに荷物数がわかるので、実行コストの見積もりに使えます。
+    ///
+    /// @param[in] aNumber ステージ番号
+    ///
+    /// @return 荷物数。1 ～ Parameter::ItemCountMax 。
+    int LevelDesigner::ItemCount(int aNumber)
+    {
+        int itemCountIndex = (aNumber / (Parameter::WallDensityMax * Parameter::PeriodSpecifiedMax)) % Parameter::ItemCountMax;
+        return itemCountIndex + 1;
+    }
+
+    //------------------------------------------------------------------------------
+    /// ステージ番号から、そのステージの時間帯指定されている荷物数を求めます。
+    ///
+    /// 割合がそのまま適用され、端数は切り捨てます。
+    /// ItemCount と同じく、ステージを生成せずに求まります。
+    ///
+    /// @param[in] aNumber ステージ番号
+    ///
+    /// @return 時間帯指定されている荷物数。0 ～ ItemCount(aNumber) 。
+    int LevelDesigner::PeriodSpecifiedCount(int aNumber)
+    {
+        int periodSpecifiedIndex = (aNumber / Parameter::WallDensityMax) % Parameter::PeriodSpecifiedMax;
+        return ItemCount(aNumber) * periodSpecifiedIndex / (Parameter::PeriodSpecifiedMax - 1);
     }
 }
 
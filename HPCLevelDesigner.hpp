@@ -23,6 +23,12 @@ namespace hpc {
         /// ステージのマップを生成します。
         static void Setup(int aNumber, Stage& aStage, Random& aRandom);
 
+        /// ステージ番号から荷物数を求めます。
+        static int ItemCount(int aNumber);
+
+        /// ステージ番号から時間帯指定されている荷物数を求めます。
+        static int PeriodSpecifiedCount(int aNumber);
+
     private:
         LevelDesigner();
     };
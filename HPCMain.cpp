@@ -10,6 +10,7 @@
 //------------------------------------------------------------------------------
 
 #include <cstring>
+#include "HPCAnswer.hpp"
 #include "HPCCommon.hpp"
 #include "HPCSimulation.hpp"
 
@@ -26,6 +27,20 @@ namespace {
     };
 
     hpc::Simulation sSim;
+
+    //------------------------------------------------------------------------------
+    /// 名前から Answer の解法の番号を求めます。
+    ///
+    /// @return 解法の番号。見つからなければ -1 。
+    int FindStrategy(const char* aName)
+    {
+        for (int i = 0; i < hpc::Answer::StrategyCount(); ++i) {
+            if (!std::strcmp(aName, hpc::Answer::StrategyName(i))) {
+                return i;
+            }
+        }
+        return -1;
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -39,35 +54,96 @@ namespace {
 ///  ------------|----------------------------------------------
 ///   -n         | デバッグを行いません。
 ///   -j         | デバッグを行わず、結果を JSON で出力します。
+///   -p         | ステージを複数スレッドで並列に実行します。他のオプションと併用できます。
+///   -d         | FastStage と結果を比べながら実行します。 -p 以外のオプションと併用できます。
+///   -pl        | ステージの生成・実行・記録をパイプラインで並行して行います。 -n や -j と併用できます。
+///   -s name    | Answer の解法を名前で選びます。他のオプションと併用できます。
+///   -b         | Answer の全ての解法で同じステージを解き、スコアと時間と勝敗を表示します。
 ///
 int main(int argc, const char* argv[])
 {
     Operation operation = Operation_Normal;
+    bool isParallel = false;
+    bool isDifferential = false;
+    bool isPipeline = false;
+    bool isBenchmark = false;
+    int strategy = -1;
     
-    // 引数は 1 つまで有効。
-    if (argc > 2) {
+    // 引数は -s とその名前、 -p か -d か -pl か -b と、それ以外の 1 つまで有効。
+    if (argc > 5) {
         HPC_PRINT("Invalid Argument.\n");
         return 0;
     }
     // 引数がある場合、引数を記録する。
-    else if (argc > 1) {
-        if (!std::strcmp(argv[1], "-n")) {
+    for (int i = 1; i < argc; ++i) {
+        const bool hasRunMode = isParallel || isDifferential || isPipeline || isBenchmark;
+        if (!std::strcmp(argv[i], "-s") && strategy < 0) {
+            strategy = i + 1 < argc ? FindStrategy(argv[i + 1]) : -1;
+            if (strategy < 0) {
+                HPC_PRINT("Invalid Argument: unknown strategy.\n");
+                for (int s = 0; s < hpc::Answer::StrategyCount(); ++s) {
+                    HPC_PRINT("  %s\n", hpc::Answer::StrategyName(s));
+                }
+                return 0;
+            }
+            ++i;
+        }
+        else if (!std::strcmp(argv[i], "-b") && !hasRunMode) {
+            isBenchmark = true;
+        }
+        else if (!std::strcmp(argv[i], "-p") && !hasRunMode) {
+            isParallel = true;
+        }
+        else if (!std::strcmp(argv[i], "-d") && !hasRunMode) {
+            isDifferential = true;
+        }
+        else if (!std::strcmp(argv[i], "-pl") && !hasRunMode) {
+            isPipeline = true;
+        }
+        else if (operation != Operation_Normal) {
+            HPC_PRINT("Invalid Argument.\n");
+            return 0;
+        }
+        else if (!std::strcmp(argv[i], "-n")) {
             operation = Operation_NoDebug;
         }
-        else if (!std::strcmp(argv[1], "-j")) {
+        else if (!std::strcmp(argv[i], "-j")) {
             operation = Operation_OutputJsonCompressed;
         }
-        else if (!std::strcmp(argv[1], "-jd")) {
+        else if (!std::strcmp(argv[i], "-jd")) {
             operation = Operation_OutputJson;
         }
         else {
-            HPC_PRINT("Invalid Argument: %s is unknown command.\n", argv[1]);
+            HPC_PRINT("Invalid Argument: %s is unknown command.\n", argv[i]);
             return 0;
         }
     }
+    if (strategy >= 0) {
+        hpc::Answer::SelectStrategy(strategy);
+    }
+    // 全解法を比べる場合は、結果を表示して終わる。
+    if (isBenchmark) {
+        sSim.runBenchmark();
+        return 0;
+    }
     // プログラムの実行
     {
-        sSim.run();
+        if (isParallel) {
+            sSim.runParallel(0);
+        }
+        else if (isDifferential) {
+            sSim.runDifferential();
+        }
+        else if (isPipeline) {
+            sSim.runPipeline(0);
+        }
+        else if (operation == Operation_NoDebug) {
+            // スコアと時間しか表示しないので、毎ターンの結果は記録しない。
+            sSim.runScoreOnly();
+        }
+        else {
+            sSim.run();
+        }
 
         switch (operation) {
         case Operation_Normal:
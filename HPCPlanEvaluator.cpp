@@ -0,0 +1,249 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief    HPCPlanEvaluator.hpp の実装
+/// @author   ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+
+#include "HPCPlanEvaluator.hpp"
+
+#include "HPCCommon.hpp"
+#include "HPCFieldDistance.hpp"
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// クラスのインスタンスを生成します。
+    PlanEvaluator::PlanEvaluator()
+        : mItemCount(0)
+        , mScoreBase(0)
+        , mWeights()
+        , mPeriods()
+        , mDistances()
+        , mPassCounts()
+        , mPassItems()
+        , mPassOffsets()
+    {
+    }
+
+    //------------------------------------------------------------------------------
+    /// 営業所と配達先の各組について、距離と経路上の配達先を前計算します。
+    ///
+    /// 経路は Field::nextAction と同じ次の一手の表をたどって求めるので、
+    /// 1マスずつ動かした場合と同じマスを通ります。
+    ///
+    /// @param[in] aField  フィールド情報。
+    /// @param[in] aItems  荷物情報。
+    void PlanEvaluator::setup(const Field& aField, const ItemCollection& aItems)
+    {
+        mItemCount = aItems.count();
+        mScoreBase = aField.width() * aField.height() * mItemCount * 10000;
+
+        const FieldDistance& table = aField.distances();
+        int nodeCells[NodeCount];
+        int cellItems[FieldDistance::CellCountMax];
+        for (int cell = 0; cell < table.cellCount(); ++cell) {
+            cellItems[cell] = -1;
+        }
+        for (int i = 0; i < mItemCount; ++i) {
+            mWeights[i] = aItems[i].weight();
+            mPeriods[i] = aItems[i].period();
+            nodeCells[i] = table.cellIndex(aItems[i].destination());
+            cellItems[nodeCells[i]] = i;
+        }
+        nodeCells[OfficeNode] = table.cellIndex(aField.officePos());
+
+        for (int to = 0; to < NodeCount; ++to) {
+            if (to < OfficeNode && to >= mItemCount) {
+                continue;
+            }
+
+            // 各出発地から、目的地へ向かう次の一手をたどって経路上の配達先を集める。
+            const uint16_t* distances = table.row(nodeCells[to]);
+            const uint8_t* nextActions = table.nextActions(nodeCells[to]);
+            for (int from = 0; from < NodeCount; ++from) {
+                if (from < OfficeNode && from >= mItemCount) {
+                    continue;
+                }
+                int cell = nodeCells[from];
+                const int distance = distances[cell];
+                HPC_ASSERT(distance != FieldDistance::Unreachable);
+                mDistances[from][to] = distance;
+                mPassCounts[from][to] = 0;
+                for (int offset = 1; offset < distance; ++offset) {
+                    cell = table.neighbor(cell, static_cast<Action>(nextActions[cell]));
+                    const int item = cellItems[cell];
+                    if (item >= 0) {
+                        const int index = mPassCounts[from][to]++;
+                        mPassItems[from][to][index] = item;
+                        mPassOffsets[from][to][index] = offset;
+                    }
+                }
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return 荷物 aFrom の配達先から荷物 aTo の配達先までの距離。
+    int PlanEvaluator::itemDistance(int aFrom, int aTo)const
+    {
+        HPC_RANGE_ASSERT_MIN_UB_I(aFrom, 0, mItemCount);
+        HPC_RANGE_ASSERT_MIN_UB_I(aTo, 0, mItemCount);
+        return mDistances[aFrom][aTo];
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return 営業所から荷物の配達先までの距離。逆向きも同じです。
+    int PlanEvaluator::officeDistance(int aItemIndex)const
+    {
+        HPC_RANGE_ASSERT_MIN_UB_I(aItemIndex, 0, mItemCount);
+        return mDistances[OfficeNode][aItemIndex];
+    }
+
+    //------------------------------------------------------------------------------
+    /// 配達計画を評価します。
+    ///
+    /// 積み込みの検査は Stage::runTurn と同じ規則で行い、妥当でなければ StageState_Failed になります。
+    /// 1つの時間帯に同じ荷物が2回以上現れる場合は、 ItemGroup に積むのと同じく1回だけ積み込み、
+    /// 訪問順では最初に現れた位置で配達します。
+    /// 別の時間帯にも現れる場合は、配達済みの荷物を積み込んだものとして扱います。
+    /// ターン数は、時間帯ごとに積み込みの1ターンと移動距離の和になり、
+    /// 1ステージのターン数を超えると StageState_TurnLimit になります。
+    ///
+    /// @param[in]  aPlan    配達計画。
+    /// @param[out] aResult  評価結果。
+    void PlanEvaluator::evaluate(const DeliveryPlan& aPlan, PlanResult& aResult)const
+    {
+        aResult.reset();
+        int transportedBits = 0;
+        for (int period = 0; period < Parameter::PeriodCount; ++period) {
+            // トラックに積み込む荷物が妥当か検査。
+            bool isValid = true;
+            int itemBits = 0;
+            int weight = 0;
+            for (int i = 0; i < aPlan.count(period); ++i) {
+                const int item = aPlan.item(period, i);
+                if (item < 0 || mItemCount <= item) {
+                    // 存在しない荷物を積み込もうとした。
+                    isValid = false;
+                    break;
+                }
+                const int bit = 1 << item;
+                if (itemBits & bit) {
+                    // この時間帯ですでに積み込んだ。 ItemGroup と同じく何もしない。
+                    continue;
+                }
+                if (transportedBits & bit) {
+                    // 配達済みの荷物を積み込もうとした。
+                    isValid = false;
+                }
+                if (mPeriods[item] >= 0 && mPeriods[item] != period) {
+                    // この時間帯に配達すべきではない荷物を積み込んだ。
+                    isValid = false;
+                }
+                weight += mWeights[item];
+                if (weight > Parameter::TruckWeightCapacity) {
+                    // 最大積載重量を超えて積み込んだ。
+                    isValid = false;
+                }
+                itemBits |= bit;
+            }
+            for (int i = 0; isValid && i < mItemCount; ++i) {
+                if (itemBits & (1 << i)) {
+                    continue;
+                }
+                if (mPeriods[i] == period) {
+                    // この時間帯に配達すべき荷物を積み込まなかった。
+                    isValid = false;
+                }
+                if (period == Parameter::PeriodCount - 1 && (transportedBits & (1 << i)) == 0) {
+                    // 最後の時間帯なのに、残りの荷物をすべて積み込まなかった。
+                    isValid = false;
+                }
+            }
+            if (!isValid) {
+                aResult.state = StageState_Failed;
+                return;
+            }
+
+            // 積み込みの1ターンと、移動したマスの数だけターンが進む。
+            int distance = 0;
+            const int cost = evaluatePeriod(aPlan, period, itemBits, weight, distance);
+            aResult.turnCount += 1 + distance;
+            if (aResult.turnCount > Parameter::GameTurnPerStage) {
+                // 時間帯の途中でターン数の制限に達した。
+                aResult.turnCount = Parameter::GameTurnPerStage;
+                aResult.state = StageState_TurnLimit;
+                return;
+            }
+            aResult.periodCosts[period] = cost;
+            aResult.totalCost += cost;
+            transportedBits |= itemBits;
+            if (period == Parameter::PeriodCount - 1) {
+                aResult.state = StageState_Complete;
+                aResult.score = mScoreBase / aResult.totalCost;
+            }
+            else if (aResult.turnCount == Parameter::GameTurnPerStage) {
+                // 時間帯を終えたところでターン数の制限に達した。
+                aResult.state = StageState_TurnLimit;
+                return;
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// 1つの時間帯で消費する燃料を求めます。
+    ///
+    /// 1マスの移動に使う燃料は、移動前に積んでいる荷物の重さによって決まるので、
+    /// 経路上で荷物を降ろす地点ごとに区切って計算します。
+    ///
+    /// @param[in]  aPlan      配達計画。
+    /// @param[in]  aPeriod    配達時間帯。
+    /// @param[in]  aItemBits  積み込んだ荷物。
+    /// @param[in]  aWeight    積み込んだ荷物の重さの合計。
+    /// @param[out] aDistance  営業所に戻るまでの移動距離。
+    /// @return 消費する燃料。
+    int PlanEvaluator::evaluatePeriod(const DeliveryPlan& aPlan, int aPeriod, int aItemBits, int aWeight, int& aDistance)const
+    {
+        int cost = 0;
+        int node = OfficeNode;
+        int loadBits = aItemBits;
+        int weight = aWeight;
+        aDistance = 0;
+        for (int i = 0; i < aPlan.count(aPeriod); ++i) {
+            const int target = aPlan.item(aPeriod, i);
+            if ((loadBits & (1 << target)) == 0) {
+                // 途中で配達済み。
+                continue;
+            }
+            int offset = 0;
+            for (int j = 0; j < mPassCounts[node][target]; ++j) {
+                const int item = mPassItems[node][target][j];
+                if (loadBits & (1 << item)) {
+                    cost += (mPassOffsets[node][target][j] - offset) * (Parameter::TruckWeight + weight);
+                    offset = mPassOffsets[node][target][j];
+                    weight -= mWeights[item];
+                    loadBits &= ~(1 << item);
+                }
+            }
+            cost += (mDistances[node][target] - offset) * (Parameter::TruckWeight + weight);
+            weight -= mWeights[target];
+            loadBits &= ~(1 << target);
+            aDistance += mDistances[node][target];
+            node = target;
+        }
+        HPC_ASSERT(loadBits == 0);
+
+        // 空になったトラックで営業所に戻る。
+        cost += mDistances[node][OfficeNode] * Parameter::TruckWeight;
+        aDistance += mDistances[node][OfficeNode];
+        return cost;
+    }
+}
+
+//------------------------------------------------------------------------------
+// EOF
@@ -0,0 +1,63 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief    PlanEvaluator クラス
+/// @author   ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "HPCDeliveryPlan.hpp"
+#include "HPCField.hpp"
+#include "HPCItemCollection.hpp"
+#include "HPCParameter.hpp"
+#include "HPCPlanResult.hpp"
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// 配達計画を、1マスずつ動かさずに評価します。
+    ///
+    /// トラックは、営業所と配達先の間を最短経路で移動するものとします。
+    /// 最短経路が複数ある場合は、各マスで 左・右・下・上 の順に最初に見つかった、
+    /// 目的地に近づく方向へ進みます。
+    /// 経路の途中で積んでいる荷物の配達先を通ると、 Stage::runTurn と同じく荷物が降ろされ、
+    /// その荷物は訪問順から外れます。
+    ///
+    /// 営業所と配達先の各組について、距離と経路上の配達先を setup で Field の最短距離の表から前計算しておくので、
+    /// evaluate の計算量は荷物の数と経路上の配達先の数にしか依存しません。
+    class PlanEvaluator
+    {
+    public:
+        PlanEvaluator();
+
+        void setup(const Field& aField, const ItemCollection& aItems);  ///< 距離と経路を前計算します。
+
+        int itemDistance(int aFrom, int aTo)const;      ///< 荷物の配達先どうしの距離を返します。
+        int officeDistance(int aItemIndex)const;        ///< 営業所から荷物の配達先までの距離を返します。
+
+        void evaluate(const DeliveryPlan& aPlan, PlanResult& aResult)const; ///< 配達計画を評価します。
+
+    private:
+        /// 営業所を表す地点番号。荷物の地点番号は荷物の番号と同じです。
+        static const int OfficeNode = Parameter::ItemCountMax;
+        /// 地点の数。
+        static const int NodeCount = Parameter::ItemCountMax + 1;
+
+        int evaluatePeriod(const DeliveryPlan& aPlan, int aPeriod, int aItemBits, int aWeight, int& aDistance)const;
+
+        int mItemCount;                                         ///< 荷物の数
+        int mScoreBase;                                         ///< スコア計算用の、幅 × 高さ × 荷物数 × 10000
+        int mWeights[Parameter::ItemCountMax];                  ///< 荷物の重さ
+        int mPeriods[Parameter::ItemCountMax];                  ///< 荷物の配達時間帯指定
+        int mDistances[NodeCount][NodeCount];                   ///< 地点間の距離
+        int mPassCounts[NodeCount][NodeCount];                  ///< 地点間の経路上にある配達先の数
+        int mPassItems[NodeCount][NodeCount][Parameter::ItemCountMax];   ///< 経路上にある配達先の荷物番号
+        int mPassOffsets[NodeCount][NodeCount][Parameter::ItemCountMax]; ///< 経路上にある配達先までの距離
+    };
+}
+//------------------------------------------------------------------------------
+// EOF
@@ -0,0 +1,40 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief    HPCPlanResult.hpp の実装
+/// @author   ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+
+#include "HPCPlanResult.hpp"
+
+#include "HPCCommon.hpp"
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// クラスのインスタンスを生成します。
+    PlanResult::PlanResult()
+    {
+        reset();
+    }
+
+    //------------------------------------------------------------------------------
+    /// 値を評価前の状態で初期化します。
+    void PlanResult::reset()
+    {
+        state = StageState_Playing;
+        turnCount = 0;
+        totalCost = 0;
+        for (int i = 0; i < Parameter::PeriodCount; ++i) {
+            periodCosts[i] = 0;
+        }
+        score = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+// EOF
@@ -0,0 +1,36 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief    PlanResult 構造体
+/// @author   ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "HPCParameter.hpp"
+#include "HPCStageState.hpp"
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// 配達計画 DeliveryPlan を評価した結果を表します。
+    ///
+    /// 計画どおりにステージを最後まで実行したときの結果と同じ値になります。
+    struct PlanResult
+    {
+        PlanResult();
+
+        void reset();                                   ///< 情報を初期化します。
+
+        StageState state;                               ///< 終了時の状態
+        int turnCount;                                  ///< 終了までのターン数
+        int totalCost;                                  ///< 終わった時間帯で消費した燃料の合計
+        int periodCosts[Parameter::PeriodCount];        ///< 時間帯ごとに消費した燃料
+        int score;                                      ///< スコア。完了しなかった場合は 0 。
+    };
+}
+//------------------------------------------------------------------------------
+// EOF
@@ -54,6 +54,19 @@ namespace hpc {
     {
     }
 
+    //------------------------------------------------------------------------------
+    /// シードが等しければ、この先の乱数列も等しくなります。
+    bool Random::operator==(const Random& aRhs) const
+    {
+        return mSeedX == aRhs.mSeedX && mSeedY == aRhs.mSeedY && mSeedZ == aRhs.mSeedZ && mSeedW == aRhs.mSeedW;
+    }
+
+    //------------------------------------------------------------------------------
+    bool Random::operator!=(const Random& aRhs) const
+    {
+        return !(*this == aRhs);
+    }
+
     //------------------------------------------------------------------------------
     /// ランダムな整数値を [0, aTerm) の範囲で発生させます。
     ///
@@ -28,6 +28,9 @@ namespace hpc {
         int randMinTerm(int aMin, int aTerm);   ///< [aMin, aTerm) の範囲で乱数を取得します。
         int randMinMax(int aMin, int aMax);     ///< [aMin, aMax] の範囲で乱数を取得します。
 
+        bool operator==(const Random& aRhs) const; ///< 等しい
+        bool operator!=(const Random& aRhs) const; ///< 等しくない
+
     private:
         uint mSeedX;            ///< 乱数のシード
         uint mSeedY;            ///< 乱数のシード
@@ -60,6 +60,22 @@ namespace hpc {
         mStage[mCurrentStageIndex].writeEnd(aStage);
     }
 
+    //------------------------------------------------------------------------------
+    /// 指定したステージの記録を取得します。
+    ///
+    /// 複数のステージを並列に実行する場合に、各スレッドが自分の担当する
+    /// ステージの記録へ直接書き込むために使います。
+    /// ステージごとの記録は独立しているので、異なるステージであれば同時に書き込めます。
+    ///
+    /// @param[in] aStageIndex ステージ番号。有効な範囲の番号が指定される必要があります。
+    ///
+    /// @return 指定したステージの記録への参照。
+    RecordStage& Record::stage(int aStageIndex)
+    {
+        HPC_RANGE_ASSERT_MIN_UB_I(aStageIndex, 0, Parameter::GameStageCount);
+        return mStage[aStageIndex];
+    }
+
     //------------------------------------------------------------------------------
     /// 各ステージの合計得点を返します。
     /// すべてのステージが終了してから呼びます。
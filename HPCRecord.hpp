@@ -28,6 +28,7 @@ namespace hpc {
         void writeStartStage(int aStageIndex, const Stage& aStage); ///< ステージの記録を開始します。
         void writeTurn(const TurnResult& aResult);                  ///< 各ターンの結果を記録します。
         void writeEndStage(const Stage& aStage);                    ///< 終了時の結果を記録します。
+        RecordStage& stage(int aStageIndex);                        ///< ステージごとの記録を取得します。
         //@}
 
         /// @name 記録を読み出す関数
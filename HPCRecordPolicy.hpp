@@ -0,0 +1,50 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief    記録方針
+/// @author   ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+#pragma once
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// @brief 毎ターンの結果を含め、すべてを記録します。
+    ///
+    /// Stage::runTurn と Game の各関数のテンプレート引数に指定します。
+    /// 定数はコンパイル時に決まるので、記録しない処理はコードから取り除かれます。
+    struct FullRecordPolicy
+    {
+        static const bool IsTurnResultUpdated = true;   ///< Stage の TurnResult を毎ターン更新するか
+        static const bool IsTurnRecorded = true;        ///< 毎ターンの結果を記録するか
+        static const bool IsStageRecorded = true;       ///< ステージの開始と終了を記録するか
+    };
+
+    //------------------------------------------------------------------------------
+    /// @brief ステージごとのスコアだけを記録します。
+    ///
+    /// スコアだけが必要な実行に使います。 JSON やデバッガの表示には使えません。
+    struct SummaryRecordPolicy
+    {
+        static const bool IsTurnResultUpdated = false;  ///< Stage の TurnResult を毎ターン更新するか
+        static const bool IsTurnRecorded = false;       ///< 毎ターンの結果を記録するか
+        static const bool IsStageRecorded = true;       ///< ステージの開始と終了を記録するか
+    };
+
+    //------------------------------------------------------------------------------
+    /// @brief 何も記録しません。
+    ///
+    /// ステージのスコアは Stage::score で直接取得します。
+    struct NoRecordPolicy
+    {
+        static const bool IsTurnResultUpdated = false;  ///< Stage の TurnResult を毎ターン更新するか
+        static const bool IsTurnRecorded = false;       ///< 毎ターンの結果を記録するか
+        static const bool IsStageRecorded = false;      ///< ステージの開始と終了を記録するか
+    };
+}
+//------------------------------------------------------------------------------
+// EOF
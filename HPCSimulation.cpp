@@ -11,10 +11,20 @@
 
 #include "HPCSimulation.hpp"
 
+#include <chrono>
 #include <cstring>
 #include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "HPCAnswer.hpp"
 #include "HPCCommon.hpp"
+#include "HPCFastStage.hpp"
+#include "HPCFieldDistance.hpp"
+#include "HPCLevelDesigner.hpp"
 #include "HPCMath.hpp"
+#include "HPCStageQueue.hpp"
+#include "HPCStageScheduler.hpp"
 #include "HPCTimer.hpp"
 
 namespace {
@@ -57,6 +67,7 @@ namespace {
         DebugCommand_Prev,          ///< 前へ
         DebugCommand_Jump,          ///< 指定番号のステージにジャンプ
         DebugCommand_Show,          ///< 再度
+        DebugCommand_Replay,        ///< ステージを生成し直して再実行
         DebugCommand_Help,          ///< ヘルプを表示
         DebugCommand_Exit,          ///< 終わる
 
@@ -126,6 +137,7 @@ namespace {
             case 'p': return DebugCommandSet(DebugCommand_Prev, arg1, arg2);
             case 'd': return DebugCommandSet(DebugCommand_Show, arg1, arg2);
             case 'j': return DebugCommandSet(DebugCommand_Jump, arg1, arg2);
+            case 'r': return DebugCommandSet(DebugCommand_Replay, arg1, arg2);
             case 'h': return DebugCommandSet(DebugCommand_Help, arg1, arg2);
             case 'e': return DebugCommandSet(DebugCommand_Exit, arg1, arg2);
             default:
@@ -143,9 +155,430 @@ namespace {
         HPC_PRINT(" p           : Go to the prev stage.\n");
         HPC_PRINT(" j [stage=0] : Go to the designated stage.\n");
         HPC_PRINT(" d           : Show the result of this stage.\n");
+        HPC_PRINT(" r           : Replay this stage from its checkpoint.\n");
         HPC_PRINT(" h           : Show Help.\n");
         HPC_PRINT(" e           : Exit debugger.\n");
     }
+
+    //------------------------------------------------------------------------------
+    /// 並列実行時に、1つのステージを生成してから実行し、記録します。
+    ///
+    /// Game::startStage, Game::runTurn, Game::onStageDone を1ステージ分まとめたものです。
+    /// ステージと記録はスレッドごとに独立したものを使うので、他のスレッドと干渉しません。
+    ///
+    /// @param[in]     aStageIndex ステージ番号。
+    /// @param[in]     aCheckpoint 各ステージ開始時点の乱数。
+    /// @param[in,out] aStage      このスレッドが使うステージ。
+    /// @param[in,out] aRecord     このステージの記録。
+    /// @param[in]     aTimer      ゲームタイマー。
+    void RunStage(int aStageIndex, const hpc::StageCheckpoint& aCheckpoint, hpc::Stage& aStage, hpc::RecordStage& aRecord, const hpc::Timer& aTimer)
+    {
+        aCheckpoint.setupStage(aStageIndex, aStage);
+
+        aStage.start(aTimer.isInTime());
+        aRecord.writeStart(aStage);
+        aRecord.writeTurn(aStage.lastTurnResult());
+        while (aStage.lastTurnResult().state == hpc::StageState_Playing && aTimer.isInTime()) {
+            aStage.runTurn();
+            aRecord.writeTurn(aStage.lastTurnResult());
+            aStage.runPlannedTurns(aTimer, &aRecord);
+        }
+        aRecord.writeEnd(aStage);
+    }
+
+    //------------------------------------------------------------------------------
+    /// パイプライン実行で、1つのステージを生成から記録まで受け渡すための置き場です。
+    struct PipelineSlot
+    {
+        PipelineSlot()
+            : stageIndex(-1)
+            , stage()
+            , turns()
+            , turnCount(0)
+        {
+        }
+
+        int stageIndex;                                             ///< ステージ番号
+        hpc::Stage stage;                                           ///< ステージ
+        hpc::TurnResult turns[hpc::Parameter::GameTurnPerStage + 1]; ///< 各ターンの結果。初期状態を含めるので1多くとる。
+        int turnCount;                                              ///< 結果の数
+    };
+
+    //------------------------------------------------------------------------------
+    /// 生成済みのステージを実行し、各ターンの結果を置き場に控えます。
+    ///
+    /// Answer の初期化とターンの実行は、 Answer の状態がスレッドごとに独立しているため、
+    /// 同じスレッドで続けて行います。
+    ///
+    /// @param[in,out] aSlot   ステージの置き場。
+    /// @param[in]     aTimer  ゲームタイマー。
+    void SolveStage(PipelineSlot& aSlot, const hpc::Timer& aTimer)
+    {
+        hpc::Stage& stage = aSlot.stage;
+        stage.start(aTimer.isInTime());
+        aSlot.turnCount = 0;
+        aSlot.turns[aSlot.turnCount++] = stage.lastTurnResult();
+        while (stage.lastTurnResult().state == hpc::StageState_Playing && aTimer.isInTime()) {
+            stage.runTurn();
+            aSlot.turns[aSlot.turnCount++] = stage.lastTurnResult();
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// 置き場に控えたステージの結果を記録します。
+    ///
+    /// @param[in]     aSlot   ステージの置き場。
+    /// @param[in,out] aRecord このステージの記録。
+    void RecordSlot(const PipelineSlot& aSlot, hpc::RecordStage& aRecord)
+    {
+        aRecord.writeStart(aSlot.stage);
+        for (int i = 0; i < aSlot.turnCount; ++i) {
+            aRecord.writeTurn(aSlot.turns[i]);
+        }
+        aRecord.writeEnd(aSlot.stage);
+    }
+
+    //------------------------------------------------------------------------------
+    /// 2つの TurnResult が同じ内容かどうかを返します。
+    bool IsSameTurnResult(const hpc::TurnResult& aLhs, const hpc::TurnResult& aRhs)
+    {
+        return aLhs.initPeriod == aRhs.initPeriod
+            && aLhs.action == aRhs.action
+            && aLhs.truckPos == aRhs.truckPos
+            && aLhs.itemGroup.getBits() == aRhs.itemGroup.getBits()
+            && aLhs.periodCost == aRhs.periodCost
+            && aLhs.totalCost == aRhs.totalCost
+            && aLhs.state == aRhs.state;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 2つの PlanResult が同じ内容かどうかを返します。
+    bool IsSamePlanResult(const hpc::PlanResult& aLhs, const hpc::PlanResult& aRhs)
+    {
+        for (int i = 0; i < hpc::Parameter::PeriodCount; ++i) {
+            if (aLhs.periodCosts[i] != aRhs.periodCosts[i]) {
+                return false;
+            }
+        }
+        return aLhs.state == aRhs.state
+            && aLhs.turnCount == aRhs.turnCount
+            && aLhs.totalCost == aRhs.totalCost
+            && aLhs.score == aRhs.score;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 配達計画を、 Stage のスナップショットで1ターンずつ実行した結果を求めます。
+    ///
+    /// PlanEvaluator と同じく、トラックは計画の順でまだ積んでいる最初の荷物の配達先へ
+    /// Field::nextAction で進み、積んでいる荷物がなくなったら営業所へ戻ります。
+    ///
+    /// @param[in]  aStage   start() を呼んだステージ。状態は変更しません。
+    /// @param[in]  aPlan    配達計画。
+    /// @param[out] aResult  実行結果。
+    void SimulatePlan(const hpc::Stage& aStage, const hpc::DeliveryPlan& aPlan, hpc::PlanResult& aResult)
+    {
+        aResult.reset();
+        hpc::StageSnapshot snapshot;
+        snapshot.reset();
+        snapshot.truck.reset(aStage.field().officePos());
+        while (snapshot.state == hpc::StageState_Playing) {
+            if (aStage.isLoadTurn(snapshot)) {
+                const int period = snapshot.period + 1;
+                hpc::ItemGroup itemGroup;
+                for (int i = 0; i < aPlan.count(period); ++i) {
+                    itemGroup.addItem(aPlan.item(period, i));
+                }
+                aStage.runTurn(snapshot, itemGroup);
+            }
+            else {
+                hpc::Pos destination = aStage.field().officePos();
+                for (int i = 0; i < aPlan.count(snapshot.period); ++i) {
+                    const int item = aPlan.item(snapshot.period, i);
+                    if (snapshot.truck.itemGroup().hasItem(item)) {
+                        destination = aStage.items()[item].destination();
+                        break;
+                    }
+                }
+                aStage.runTurn(snapshot, aStage.field().nextAction(snapshot.truck.pos(), destination));
+            }
+            if (snapshot.state != hpc::StageState_Failed && aStage.isLoadTurn(snapshot)) {
+                // 時間帯が終わった。
+                aResult.periodCosts[snapshot.period] = snapshot.periodCost;
+            }
+        }
+        aResult.state = snapshot.state;
+        aResult.turnCount = snapshot.turnIndex;
+        aResult.totalCost = snapshot.totalCost;
+        aResult.score = aStage.score(snapshot);
+    }
+
+    //------------------------------------------------------------------------------
+    /// 実際に積み込んだ荷物と配達したターンから、配達計画を作ります。
+    ///
+    /// 各時間帯の荷物は配達したターンの順に並べ、配達されなかった荷物は荷物の番号順に末尾へ置きます。
+    ///
+    /// @param[in]  aItemCount       荷物の数。
+    /// @param[in]  aItemPeriods     荷物ごとの、積み込んだ時間帯。積み込まなかった荷物は -1 。
+    /// @param[in]  aDeliveredTurns  荷物ごとの、配達したターン。配達されなかった荷物は GameTurnPerStage 。
+    /// @param[in]  aIsReversed      時間帯ごとの並びを逆にするかどうか。
+    /// @param[out] aPlan            配達計画。
+    void BuildDeliveryPlan(int aItemCount, const int* aItemPeriods, const int* aDeliveredTurns, bool aIsReversed, hpc::DeliveryPlan& aPlan)
+    {
+        aPlan.reset();
+        for (int period = 0; period < hpc::Parameter::PeriodCount; ++period) {
+            int order[hpc::Parameter::ItemCountMax];
+            int count = 0;
+            for (int turn = 0; turn <= hpc::Parameter::GameTurnPerStage && count < aItemCount; ++turn) {
+                for (int i = 0; i < aItemCount; ++i) {
+                    if (aItemPeriods[i] == period && aDeliveredTurns[i] == turn) {
+                        order[count++] = i;
+                    }
+                }
+            }
+            for (int i = 0; i < count; ++i) {
+                aPlan.add(period, order[aIsReversed ? count - 1 - i : i]);
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// 配達計画の各時間帯の末尾に、その時間帯の最初の荷物をもう1回加えます。
+    ///
+    /// 同じ荷物を2回積み込もうとしても、 ItemGroup と同じく1回だけ積むことになるので、
+    /// 結果は元の計画と同じになるはずです。荷物の数が上限の時間帯には加えません。
+    void DuplicateFirstItems(hpc::DeliveryPlan& aPlan)
+    {
+        for (int period = 0; period < hpc::Parameter::PeriodCount; ++period) {
+            if (0 < aPlan.count(period) && aPlan.count(period) < hpc::Parameter::ItemCountMax) {
+                aPlan.add(period, aPlan.item(period, 0));
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// Stage::evaluatePlan の結果が、同じ計画を1ターンずつ実行した結果と一致するか確かめます。
+    ///
+    /// @return 一致すれば 0 、食い違えば 1 。
+    int CheckPlanEvaluation(int aStageIndex, const hpc::Stage& aStage, const hpc::DeliveryPlan& aPlan)
+    {
+        hpc::PlanResult evaluated;
+        hpc::PlanResult simulated;
+        aStage.evaluatePlan(aPlan, evaluated);
+        SimulatePlan(aStage, aPlan, simulated);
+        if (IsSamePlanResult(evaluated, simulated)) {
+            return 0;
+        }
+        HPC_PRINT_LOG("Diff", "stage %d: evaluatePlan state %d turn %d cost %d != runTurn state %d turn %d cost %d\n", aStageIndex
+            , evaluated.state, evaluated.turnCount, evaluated.totalCost
+            , simulated.state, simulated.turnCount, simulated.totalCost);
+        return 1;
+    }
+
+    //------------------------------------------------------------------------------
+    /// ステージの Field が生成時に作った最短距離の表を、別の求め方と比べます。
+    ///
+    /// 作ってある行が、 FieldDistance::buildAll で全ての行を並列に作った表と、距離と次の一手が全て一致することを確かめます。
+    ///
+    /// @return 一致すれば 0 、食い違えば 1 。
+    int CheckFieldDistance(int aStageIndex, const hpc::Stage& aStage)
+    {
+        const hpc::Field& field = aStage.field();
+        const hpc::FieldDistance& built = field.distances();
+        hpc::FieldDistance all;
+        all.setup(field);
+        all.buildAll(0);
+        for (int to = 0; to < built.cellCount(); ++to) {
+            if (!built.hasRow(to)) {
+                continue;
+            }
+            const uint16_t* builtRow = built.row(to);
+            const uint8_t* builtActions = built.nextActions(to);
+            const uint16_t* allRow = all.row(to);
+            const uint8_t* allActions = all.nextActions(to);
+            for (int from = 0; from < built.cellCount(); ++from) {
+                if (builtRow[from] != allRow[from] || builtActions[from] != allActions[from]) {
+                    HPC_PRINT_LOG("Diff", "stage %d: FieldDistance::buildAll mismatch at cell %d -> %d\n", aStageIndex, from, to);
+                    return 1;
+                }
+            }
+        }
+
+        return 0;
+    }
+
+    //------------------------------------------------------------------------------
+    /// ステージを1つ実行し、同じ積み込みと行動を FastStage でも実行して結果を比べます。
+    ///
+    /// 実行した積み込みと配達の順から配達計画を作り、 Stage::evaluatePlan の結果も
+    /// その計画を1ターンずつ実行した結果と比べます。並びを逆にした計画でも比べるので、
+    /// 経路の途中で荷物を降ろす場合も確かめられます。
+    /// 同じ荷物を2回積み込む計画でも比べます。
+    /// 最短距離の表も、 CheckFieldDistance で別の求め方と比べます。
+    ///
+    /// 記録は RunStage と同じく Stage の結果で行います。
+    /// 結果が食い違った場合は、最初に食い違ったターンを表示します。
+    ///
+    /// @param[in]     aStageIndex ステージ番号。
+    /// @param[in]     aCheckpoint 各ステージ開始時点の乱数。
+    /// @param[in,out] aStage      基準となるステージ。
+    /// @param[in,out] aFastStage  比べるステージ。
+    /// @param[in,out] aRecord     このステージの記録。
+    /// @param[in]     aTimer      ゲームタイマー。
+    ///
+    /// @return 結果が食い違ったターンとスコア、配達計画の評価、最短距離の表の数。
+    int RunStageDifferential(int aStageIndex, const hpc::StageCheckpoint& aCheckpoint, hpc::Stage& aStage, hpc::FastStage& aFastStage, hpc::RecordStage& aRecord, const hpc::Timer& aTimer)
+    {
+        int mismatchCount = 0;
+        int turn = 0;
+        int itemPeriods[hpc::Parameter::ItemCountMax];
+        int deliveredTurns[hpc::Parameter::ItemCountMax];
+        for (int i = 0; i < hpc::Parameter::ItemCountMax; ++i) {
+            itemPeriods[i] = -1;
+            deliveredTurns[i] = hpc::Parameter::GameTurnPerStage;
+        }
+        aCheckpoint.setupStage(aStageIndex, aStage);
+
+        aStage.start(aTimer.isInTime());
+        aFastStage.setup(aStage);
+        aFastStage.start();
+        aRecord.writeStart(aStage);
+        aRecord.writeTurn(aStage.lastTurnResult());
+        while (true) {
+            if (!IsSameTurnResult(aStage.lastTurnResult(), aFastStage.lastTurnResult())) {
+                if (mismatchCount == 0) {
+                    HPC_PRINT_LOG("Diff", "stage %d turn %d: TurnResult mismatch\n", aStageIndex, turn);
+                }
+                ++mismatchCount;
+            }
+            if (aStage.lastTurnResult().state != hpc::StageState_Playing || !aTimer.isInTime()) {
+                break;
+            }
+
+            const int truckBits = aStage.snapshot().truck.itemGroup().getBits();
+            aStage.runTurn();
+            const hpc::TurnResult& result = aStage.lastTurnResult();
+            if (result.initPeriod) {
+                aFastStage.runTurn(aStage.lastLoadItems());
+                for (int i = 0; i < aStage.items().count(); ++i) {
+                    if (aStage.lastLoadItems().hasItem(i)) {
+                        itemPeriods[i] = aStage.snapshot().period;
+                    }
+                }
+            }
+            else {
+                aFastStage.runTurn(result.action);
+                const int deliveredBits = truckBits & ~aStage.snapshot().truck.itemGroup().getBits();
+                for (int i = 0; i < aStage.items().count(); ++i) {
+                    if (deliveredBits & (1 << i)) {
+                        deliveredTurns[i] = turn;
+                    }
+                }
+            }
+            aRecord.writeTurn(result);
+            ++turn;
+        }
+        if (aStage.score() != aFastStage.score()) {
+            HPC_PRINT_LOG("Diff", "stage %d: score %d != %d\n", aStageIndex, aStage.score(), aFastStage.score());
+            ++mismatchCount;
+        }
+        for (int reversed = 0; reversed < 2; ++reversed) {
+            hpc::DeliveryPlan plan;
+            BuildDeliveryPlan(aStage.items().count(), itemPeriods, deliveredTurns, reversed != 0, plan);
+            mismatchCount += CheckPlanEvaluation(aStageIndex, aStage, plan);
+            DuplicateFirstItems(plan);
+            mismatchCount += CheckPlanEvaluation(aStageIndex, aStage, plan);
+        }
+        mismatchCount += CheckFieldDistance(aStageIndex, aStage);
+        aRecord.writeEnd(aStage);
+        return mismatchCount;
+    }
+
+    //------------------------------------------------------------------------------
+    /// ベンチマークで勝敗を数えるときに、ステージを荷物数で分ける幅
+    const int BenchmarkCategoryItemCount = 4;
+    /// ベンチマークで勝敗を数えるステージの分類の数
+    const int BenchmarkCategoryCount = (hpc::Parameter::ItemCountMax + BenchmarkCategoryItemCount - 1) / BenchmarkCategoryItemCount;
+
+    //------------------------------------------------------------------------------
+    /// ベンチマークの結果を表示します。
+    ///
+    /// 解法ごとに、スコア、全体と1ステージあたりの解く時間、
+    /// 荷物数で分けたステージの分類ごとの勝ち・引き分け・負けの数を表示します。
+    /// 勝ちは他のどの解法よりスコアが高いステージ、引き分けは最高スコアが複数の解法で並んだステージです。
+    ///
+    /// @param[in] aScores  [解法 * GameStageCount + ステージ番号] ごとのスコア。
+    /// @param[in] aTimes   [解法 * GameStageCount + ステージ番号] ごとの解く時間(秒)。
+    void PrintBenchmark(const std::vector<int>& aScores, const std::vector<double>& aTimes)
+    {
+        const int strategyCount = hpc::Answer::StrategyCount();
+        const int stageCount = hpc::Parameter::GameStageCount;
+
+        HPC_PRINT_LOG("Bench", "%-10s %10s %10s %10s %10s\n", "strategy", "score", "total(s)", "mean(ms)", "max(ms)");
+        for (int strategy = 0; strategy < strategyCount; ++strategy) {
+            long long score = 0;
+            double total = 0.0;
+            double maxTime = 0.0;
+            for (int stageIndex = 0; stageIndex < stageCount; ++stageIndex) {
+                const double time = aTimes[strategy * stageCount + stageIndex];
+                score += aScores[strategy * stageCount + stageIndex];
+                total += time;
+                if (maxTime < time) {
+                    maxTime = time;
+                }
+            }
+            HPC_PRINT_LOG("Bench", "%-10s %10lld %10.4f %10.4f %10.4f\n"
+                , hpc::Answer::StrategyName(strategy)
+                , score / hpc::Parameter::RepeatCount
+                , total
+                , total * 1000.0 / stageCount
+                , maxTime * 1000.0
+                );
+        }
+
+        // 分類ごとの勝ち・引き分け・負け
+        std::vector<int> wins(strategyCount * BenchmarkCategoryCount, 0);
+        std::vector<int> ties(strategyCount * BenchmarkCategoryCount, 0);
+        std::vector<int> losses(strategyCount * BenchmarkCategoryCount, 0);
+        for (int stageIndex = 0; stageIndex < stageCount; ++stageIndex) {
+            const int category = (hpc::LevelDesigner::ItemCount(stageIndex) - 1) / BenchmarkCategoryItemCount;
+            int best = 0;
+            int bestCount = 0;
+            for (int strategy = 0; strategy < strategyCount; ++strategy) {
+                const int score = aScores[strategy * stageCount + stageIndex];
+                if (bestCount == 0 || best < score) {
+                    best = score;
+                    bestCount = 1;
+                }
+                else if (score == best) {
+                    ++bestCount;
+                }
+            }
+            for (int strategy = 0; strategy < strategyCount; ++strategy) {
+                const int index = strategy * BenchmarkCategoryCount + category;
+                if (aScores[strategy * stageCount + stageIndex] != best) {
+                    ++losses[index];
+                }
+                else if (bestCount == 1) {
+                    ++wins[index];
+                }
+                else {
+                    ++ties[index];
+                }
+            }
+        }
+        HPC_PRINT_LOG("Bench", "win/tie/loss by item count\n");
+        for (int category = 0; category < BenchmarkCategoryCount; ++category) {
+            HPC_PRINT_LOG("Bench", "items %2d-%2d:"
+                , category * BenchmarkCategoryItemCount + 1
+                , hpc::Math::Min((category + 1) * BenchmarkCategoryItemCount, hpc::Parameter::ItemCountMax)
+                );
+            for (int strategy = 0; strategy < strategyCount; ++strategy) {
+                const int index = strategy * BenchmarkCategoryCount + category;
+                HPC_PRINT(" %s %d/%d/%d", hpc::Answer::StrategyName(strategy), wins[index], ties[index], losses[index]);
+            }
+            HPC_PRINT("\n");
+        }
+    }
 }
 
 namespace hpc {
@@ -162,16 +595,239 @@ namespace hpc {
     //------------------------------------------------------------------------------
     /// @brief ゲームを実行します。
     void Simulation::run()
+    {
+        runStages<FullRecordPolicy>();
+    }
+
+    //------------------------------------------------------------------------------
+    /// @brief ゲームを、ステージごとのスコアだけを記録して実行します。
+    ///
+    /// 毎ターンの結果を記録しないので、スコアだけが必要な場合に使います。
+    /// 実行後に JSON の出力やデバッガは使えません。
+    void Simulation::runScoreOnly()
+    {
+        runStages<SummaryRecordPolicy>();
+    }
+
+    //------------------------------------------------------------------------------
+    /// @brief 記録方針を指定してゲームを実行します。
+    ///
+    /// @tparam TRecordPolicy 記録方針。
+    template <class TRecordPolicy>
+    void Simulation::runStages()
     {
         // 制限時間と制限ターン数
         mTimer.start();
         while (mGame.isValidStage()) {
-            mGame.startStage(mTimer.isInTime());
+            mGame.startStage<TRecordPolicy>(mTimer.isInTime());
             while (mGame.state() == StageState_Playing && mTimer.isInTime()) {
-                mGame.runTurn();
+                mGame.runTurn<TRecordPolicy>();
+                mGame.runPlannedTurns<TRecordPolicy>(mTimer);
+            }
+            mGame.onStageDone<TRecordPolicy>();
+        }
+        mTimer.stop();
+    }
+
+    //------------------------------------------------------------------------------
+    /// @brief ゲームを複数スレッドで実行します。
+    ///
+    /// 各ステージ開始時点の乱数を先に求めておき、ステージを重い順にワーカーへ配って並列に実行します。
+    /// 記録はステージ番号の位置に書き込まれ、スコアはステージ順に合計されるので、
+    /// Answer の計画がステージだけで決まるなら、結果は run() と一致します。 make check で確かめられます。
+    ///
+    /// CPU 時間は全ワーカーの合計で進むので、制限時間は実時間で測ります。
+    ///
+    /// @attention Answer がスレッドごとに独立した状態を持ち、
+    ///            実行の順番や経過時間によらず、ステージごとに同じ計画を立てる必要があります。
+    ///
+    /// @param[in] aThreadCount スレッド数。0 の場合はハードウェアの並列数を使います。
+    void Simulation::runParallel(int aThreadCount)
+    {
+        int threadCount = aThreadCount;
+        if (threadCount <= 0) {
+            threadCount = Math::Max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+        }
+
+        mTimer.start(TimerClock_WallTime);
+
+        // ステージの生成は乱数を順番に消費するので、各ステージ開始時点の乱数を先に求めておく。
+        mGame.buildCheckpoint();
+
+        StageScheduler scheduler(threadCount);
+        scheduler.setupCostlyFirst();
+
+        const StageCheckpoint& checkpoint = mGame.checkpoint();
+        Record& record = mGame.record();
+        std::vector<std::thread> threads;
+        for (int worker = 0; worker < threadCount; ++worker) {
+            threads.push_back(std::thread([this, worker, &scheduler, &checkpoint, &record]() {
+                Stage stage;
+                int stageIndex = 0;
+                while (scheduler.pop(worker, stageIndex)) {
+                    RunStage(stageIndex, checkpoint, stage, record.stage(stageIndex), mTimer);
+                }
+            }));
+        }
+        for (std::size_t i = 0; i < threads.size(); ++i) {
+            threads[i].join();
+        }
+        mTimer.stop();
+    }
+
+    //------------------------------------------------------------------------------
+    /// @brief ステージの生成、実行、記録をパイプラインで並行して行います。
+    ///
+    /// 生成スレッドが乱数を順番に使ってステージを生成し、実行スレッドの集まりが
+    /// Answer の初期化とターンの実行を行い、このスレッドがステージ番号の順に記録します。
+    /// 置き場の数を固定しているので、生成が記録より先に進みすぎることはありません。
+    /// 各ステージは専用の置き場で扱われ、記録はステージ順に行われるので、
+    /// Answer の計画がステージだけで決まるなら、結果は run() と一致します。 make check で確かめられます。
+    ///
+    /// CPU 時間は全スレッドの合計で進むので、制限時間は実時間で測ります。
+    ///
+    /// @attention Answer がスレッドごとに独立した状態を持ち、
+    ///            実行の順番や経過時間によらず、ステージごとに同じ計画を立てる必要があります。
+    ///
+    /// @param[in] aSolverCount 実行スレッド数。0 の場合はハードウェアの並列数を使います。
+    void Simulation::runPipeline(int aSolverCount)
+    {
+        int solverCount = aSolverCount;
+        if (solverCount <= 0) {
+            solverCount = Math::Max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+        }
+
+        mTimer.start(TimerClock_WallTime);
+
+        // 実行中と、その前後で待っているステージの分だけ置き場を用意する。
+        const int slotCount = solverCount * 2 + 2;
+        std::vector<std::unique_ptr<PipelineSlot> > slots;
+        StageQueue freeSlots;
+        for (int i = 0; i < slotCount; ++i) {
+            slots.push_back(std::unique_ptr<PipelineSlot>(new PipelineSlot()));
+            freeSlots.push(i);
+        }
+        StageQueue generatedSlots;
+        StageQueue solvedSlots;
+
+        // 生成
+        std::thread generator([this, &slots, &freeSlots, &generatedSlots]() {
+            for (int stageIndex = 0; stageIndex < Parameter::GameStageCount; ++stageIndex) {
+                int slot = 0;
+                freeSlots.pop(slot);
+                slots[slot]->stageIndex = stageIndex;
+                mGame.setupStage(stageIndex, slots[slot]->stage);
+                generatedSlots.push(slot);
+            }
+            generatedSlots.close();
+        });
+
+        // 実行
+        std::vector<std::thread> solvers;
+        for (int i = 0; i < solverCount; ++i) {
+            solvers.push_back(std::thread([this, &slots, &generatedSlots, &solvedSlots]() {
+                int slot = 0;
+                while (generatedSlots.pop(slot)) {
+                    SolveStage(*slots[slot], mTimer);
+                    solvedSlots.push(slot);
+                }
+            }));
+        }
+
+        // 記録
+        // 実行が終わった順に届くので、ステージ番号の順に並べ直して記録する。
+        Record& record = mGame.record();
+        std::vector<int> solvedSlotOfStage(Parameter::GameStageCount, -1);
+        int nextStageIndex = 0;
+        while (nextStageIndex < Parameter::GameStageCount) {
+            int slot = 0;
+            solvedSlots.pop(slot);
+            solvedSlotOfStage[slots[slot]->stageIndex] = slot;
+            while (nextStageIndex < Parameter::GameStageCount && solvedSlotOfStage[nextStageIndex] >= 0) {
+                const int recordSlot = solvedSlotOfStage[nextStageIndex];
+                RecordSlot(*slots[recordSlot], record.stage(nextStageIndex));
+                freeSlots.push(recordSlot);
+                ++nextStageIndex;
+            }
+        }
+
+        generator.join();
+        for (std::size_t i = 0; i < solvers.size(); ++i) {
+            solvers[i].join();
+        }
+        mTimer.stop();
+    }
+
+    //------------------------------------------------------------------------------
+    /// @brief ゲームを実行し、 Stage と FastStage 、 Stage::evaluatePlan の結果を比べます。
+    ///
+    /// Answer は Stage で実行し、その積み込みと行動を FastStage に与えて、
+    /// 毎ターンの TurnResult とステージのスコアが一致することを確かめます。
+    /// さらに、実行した積み込みと配達の順を配達計画にして、 Stage::evaluatePlan の結果が
+    /// 同じ計画を runTurn で1ターンずつ実行した結果と一致することを確かめます。
+    /// 最短距離の表も、全ての行を並列に作った表と比べます。
+    /// 記録とスコアは run() と同じになり、食い違いがあった場合だけ表示とアサートを行います。
+    /// 規則の実装を変更したときの確認に使います。
+    void Simulation::runDifferential()
+    {
+        mTimer.start();
+        mGame.buildCheckpoint();
+
+        const StageCheckpoint& checkpoint = mGame.checkpoint();
+        Record& record = mGame.record();
+        Stage stage;
+        FastStage fastStage;
+        int mismatchStageCount = 0;
+        for (int stageIndex = 0; stageIndex < Parameter::GameStageCount; ++stageIndex) {
+            if (RunStageDifferential(stageIndex, checkpoint, stage, fastStage, record.stage(stageIndex), mTimer) != 0) {
+                ++mismatchStageCount;
+            }
+        }
+        mTimer.stop();
+
+        // 一致した場合は何も表示しないので、 -j と併用しても JSON は崩れない。
+        if (mismatchStageCount != 0) {
+            HPC_PRINT_LOG("Diff", "%d / %d stages mismatched\n", mismatchStageCount, Parameter::GameStageCount);
+        }
+        HPC_ASSERT_MSG(mismatchStageCount == 0, "FastStage, Stage::evaluatePlan or the distance table does not match Stage.");
+    }
+
+    //------------------------------------------------------------------------------
+    /// @brief Answer の全ての解法で同じステージを解き、結果を比べて表示します。
+    ///
+    /// 各ステージ開始時点の乱数を先に求めておくので、どの解法も全く同じステージを解きます。
+    /// 解法ごとに Answer::SelectStrategy で解法を切り替えてから、全ステージを順に実行します。
+    /// 解く時間は、 Answer::Init を含むステージの開始から終了までの実時間です。
+    /// 結果は記録しないので、実行後に JSON の出力やデバッガは使えません。
+    void Simulation::runBenchmark()
+    {
+        mTimer.start();
+        mGame.buildCheckpoint();
+
+        const StageCheckpoint& checkpoint = mGame.checkpoint();
+        const int strategyCount = Answer::StrategyCount();
+        std::vector<int> scores(strategyCount * Parameter::GameStageCount, 0);
+        std::vector<double> times(strategyCount * Parameter::GameStageCount, 0.0);
+        Stage stage;
+        for (int strategy = 0; strategy < strategyCount; ++strategy) {
+            Answer::SelectStrategy(strategy);
+            for (int stageIndex = 0; stageIndex < Parameter::GameStageCount; ++stageIndex) {
+                checkpoint.setupStage(stageIndex, stage);
+                const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+                stage.start(true);
+                while (stage.state() == StageState_Playing) {
+                    stage.runTurn<NoRecordPolicy>();
+                }
+                const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+                scores[strategy * Parameter::GameStageCount + stageIndex] = stage.score();
+                times[strategy * Parameter::GameStageCount + stageIndex] = std::chrono::duration<double>(end - begin).count();
             }
-            mGame.onStageDone();
         }
+        // 後で通常の実行をしても既定の解法になるように戻しておく。
+        Answer::SelectStrategy(0);
+        mTimer.stop();
+
+        PrintBenchmark(scores, times);
     }
 
     //------------------------------------------------------------------------------
@@ -233,6 +889,29 @@ namespace hpc {
         }
     }
 
+    //------------------------------------------------------------------------------
+    /// 指定したステージだけを、開始時点の乱数から生成し直して再実行します。
+    ///
+    /// 前のステージを実行し直す必要がないので、1つのステージの再現確認に使えます。
+    /// 再実行の結果は記録には反映されません。
+    ///
+    /// @param[in] aStageIndex ステージ番号。
+    void Simulation::replayStage(int aStageIndex)
+    {
+        if (!mGame.checkpoint().hasStage(aStageIndex)) {
+            HPC_PRINT("Stage %d has no checkpoint.\n", aStageIndex);
+            return;
+        }
+
+        Stage stage;
+        mGame.checkpoint().setupStage(aStageIndex, stage);
+        stage.start(true);
+        while (stage.state() == StageState_Playing) {
+            stage.runTurn<NoRecordPolicy>();
+        }
+        HPC_PRINT_LOG("Replay", "%d (recorded: %d)\n", stage.score(), mGame.record().stage(aStageIndex).score());
+    }
+
     //------------------------------------------------------------------------------
     /// デバッグ実行を行います。
     void Simulation::runDebugger()
@@ -259,6 +938,10 @@ namespace hpc {
                     stage = Math::LimitMinMax(commandSet.arg1, 0, Parameter::GameStageCount - 1);
                     break;
 
+                case DebugCommand_Replay:
+                    replayStage(stage);
+                    break;
+
                 case DebugCommand_Help:
                     ShowHelp();
                     break;
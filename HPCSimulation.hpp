@@ -24,6 +24,11 @@ namespace hpc {
         Simulation();
 
         void run();                                    ///< 開始する
+        void runScoreOnly();                           ///< スコアだけを記録して開始する
+        void runParallel(int aThreadCount);            ///< 複数スレッドで開始する
+        void runPipeline(int aSolverCount);            ///< 生成・実行・記録を並行して開始する
+        void runDifferential();                        ///< 高速な実装と比べながら開始する
+        void runBenchmark();                           ///< 全ての解法で同じステージを解いて比べる
         int score() const;                             ///< スコアを取得
         double pastTimeSecForPrint() const;            ///< 表示用時間取得
         void debug();                                  ///< デバッグする
@@ -35,7 +40,11 @@ namespace hpc {
         Game mGame;         ///< シミュレーションするゲーム
         Timer mTimer;       ///< ゲームタイマー
 
+        template <class TRecordPolicy>
+        void runStages();
+
         void runDebugger();
+        void replayStage(int aStageIndex);
     };
 }
 //------------------------------------------------------------------------------
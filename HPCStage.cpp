@@ -14,6 +14,8 @@
 #include "HPCAnswer.hpp"
 #include "HPCCommon.hpp"
 #include "HPCParameter.hpp"
+#include "HPCRecordStage.hpp"
+#include "HPCTimer.hpp"
 
 namespace hpc {
 
@@ -21,14 +23,16 @@ namespace hpc {
     /// クラスのインスタンスを生成します。
     Stage::Stage()
         : mField()
-        , mPeriod(0)
-        , mPeriodCost(0)
-        , mTotalCost(0)
         , mItems()
-        , mTransportStates()
-        , mTruck(*this)
+        , mNumber(0)
+        , mState()
         , mTurnResult()
-        , mTurnIndex(0)
+        , mDestinationItems()
+        , mActionPlan()
+        , mPlanIndex(0)
+        , mPlanEvaluator()
+        , mIsPlanEvaluatorReady(false)
+        , mLoadItems()
     {
     }
 
@@ -40,27 +44,29 @@ namespace hpc {
     ///       ステージの初期状態を取得することができます。
     void Stage::start(bool aIsInTime)
     {
-        mTurnResult.state = StageState_Playing;
-        mTurnIndex = 0;
+        // 配達時間帯、消費した燃料、配達状況、ターン番号を初期化
+        // 配達時間帯は最初は-1で、時間帯ごとの初期化をするときにインクリメントされる。
+        mState.reset();
 
-        // 配達時間帯を初期化
-        // 最初は-1で、時間帯ごとの初期化をするときにインクリメントされる。
-        mPeriod = -1;
-
-        // 消費した燃料を初期化
-        mPeriodCost = 0;
-        mTotalCost = 0;
-
-        // 配達状況を初期化
-        for (int i = 0; i < items().count(); ++i) {
-            mTransportStates[i] = TransportState_NotTransported;
+        // トラックを初期化
+        mState.truck.reset(field().officePos());
+        mActionPlan.reset();
+        mPlanIndex = 0;
+        mLoadItems.reset();
+
+        // 配達先から荷物を引けるようにする
+        for (int y = 0; y < Parameter::FieldHeightMax; ++y) {
+            for (int x = 0; x < Parameter::FieldWidthMax; ++x) {
+                mDestinationItems[y][x] = -1;
+            }
         }
-        for (int i = items().count(); i < Parameter::ItemCountMax; ++i) {
-            mTransportStates[i] = TransportState_TERM; // 存在しない荷物には TERM を設定しておく。
+        for (int i = 0; i < items().count(); ++i) {
+            const Pos& dest = items()[i].destination();
+            mDestinationItems[dest.y][dest.x] = i;
         }
 
-        // トラックを初期化
-        truck().reset();
+        // 配達計画の評価器は、最初に評価するときに作る
+        mIsPlanEvaluatorReady = false;
 
         // Answerを初期化
         if (aIsInTime) {
@@ -80,29 +86,33 @@ namespace hpc {
     }
 
     //------------------------------------------------------------------------------
-    /// Actionを実行します。
-    int Stage::runAction(Action aAction)
+    /// ステージ内での現在の状態を返します。
+    ///
+    /// lastTurnResult と異なり、記録方針によらず常に最新の状態を返します。
+    StageState Stage::state()const
     {
-        int cost = Parameter::TruckWeight;
-        for (int i = 0; i < mItems.count(); ++i) {
-            if (truck().itemGroup().hasItem(i)) {
-                cost += items()[i].weight();
-           }
-        }
-        Pos nextPos = truck().pos().move(aAction);
-        if (field().isWall(nextPos) == false) {
-            truck().setPos(nextPos);
-            // 配達できたか調べる
-            for (int i = 0; i < mItems.count(); ++i) {
-                if (truck().itemGroup().hasItem(i)) {
-                    if (nextPos == items()[i].destination()) {
-                        truck().itemGroup().removeItem(i);
-                    }
-                }
-            }
-        }
+        return mState.state;
+    }
 
-        return cost;
+    //------------------------------------------------------------------------------
+    /// 配達中に、Answer::InitPeriodPlan で設定された行動計画がまだ残っているかどうかを返します。
+    ///
+    /// 行動計画が残っている間は、runTurn は Answer::GetNextAction を呼ばずに計画の行動を実行します。
+    ///
+    /// @return 次の runTurn で計画の行動を実行する場合は @c true 。
+    bool Stage::hasPlannedAction()const
+    {
+        return mPlanIndex < mActionPlan.count();
+    }
+
+    //------------------------------------------------------------------------------
+    /// 最後の積み込みのターンで、 Answer::InitPeriod が指定した荷物を返します。
+    ///
+    /// 積み込みに失敗した場合も、指定された荷物がそのまま返ります。
+    /// 同じ積み込みを別の実装で再現するときに使います。
+    const ItemGroup& Stage::lastLoadItems()const
+    {
+        return mLoadItems;
     }
 
     //------------------------------------------------------------------------------
@@ -110,120 +120,328 @@ namespace hpc {
     /// トラックが空で営業所にいるなら、積み込みを行い、この配達時間帯を開始します。このターンはこれで終わりです。
     /// それ以外はトラックは移動し、配達先に着いたら自動的に荷物を降ろします。
     /// トラックが空で、移動先が営業所の場合は、この配達時間帯の終了処理を行います。ここまでは、移動と同じターンで行われます。
+    ///
+    /// 積み込み時に Answer::InitPeriodPlan で行動計画が設定された場合、配達中は計画の行動を順に実行します。
+    /// 計画を使い切っても時間帯が終わらない場合は、 Answer::GetNextAction で次の行動を決めます。
+    /// どちらの場合も、ターン数の制限や自動的な荷下ろしは同じ規則で処理されます。
+    ///
+    /// @tparam TRecordPolicy 記録方針。 TurnResult を更新しない方針では、 lastTurnResult は
+    ///                       start() 直後の値のままになるので、状態は state() で取得します。
+    template <class TRecordPolicy>
     void Stage::runTurn()
     {
         bool initPeriod = false;
         Action action = Action_TERM;
-        if (truck().itemGroup().hasAnyItems() == false && truck().pos() == field().officePos()) {
+        if (isLoadTurn(mState)) {
             // トラックが空であり、かつ営業所にいるので、配達時間帯を開始する。
-            mPeriod++;
+            mState.period++;
             ItemGroup itemGroup;
             Answer::InitPeriod(*this, itemGroup);
-            mPeriodCost = 0;
-
-            // トラックに積み込まれた荷物が妥当か検査。
-            int weight = 0;
-            for (int i = 0; i < items().count(); ++i) {
-                if (itemGroup.hasItem(i)) {
-                    if (mTransportStates[i] != TransportState_NotTransported) {
-                        // 配達済みの荷物を積み込もうとした。
-                        mTurnResult.state = StageState_Failed;
-                    }
-                    if (items()[i].period() >= 0 && items()[i].period() != mPeriod) {
-                        // この時間帯に配達すべきではない荷物を積み込んだ。
-                        mTurnResult.state = StageState_Failed;
-                    }
-                    weight += items()[i].weight();
-                    if (weight > Parameter::TruckWeightCapacity) {
-                        // 最大積載重量を超えて積み込んだ。
-                        mTurnResult.state = StageState_Failed;
-                    }
-                }
-                else {
-                    if (items()[i].period() == mPeriod) {
-                        // この時間帯に配達すべき荷物を積み込まなかった。
-                        mTurnResult.state = StageState_Failed;
-                    }
-                    if (mPeriod == Parameter::PeriodCount - 1 && mTransportStates[i] == TransportState_NotTransported) {
-                        // 最後の時間帯なのに、残りの荷物をすべて積み込まなかった。
-                        mTurnResult.state = StageState_Failed;
-                    }
-                }
-            }
-            for (int i = items().count(); i < Parameter::ItemCountMax; ++i) {
-                if (itemGroup.hasItem(i)) {
-                    // 存在しない荷物を積み込もうとした。
-                    mTurnResult.state = StageState_Failed;
-                }
-            }
+            mLoadItems.set(itemGroup);
+            mState.periodCost = 0;
 
-            if (mTurnResult.state == StageState_Failed) {
-                // 積み込みに失敗した場合も、JSON出力の整合性をとるため、結果は保存する。
-                updateTurnResult(true, action);
-            }
+            // トラックに積み込まれた荷物が妥当か検査し、妥当なら積み込む。
+            loadItems(mState, itemGroup);
 
-            if (mTurnResult.state == StageState_Playing) {
-                // トラックに積み込まれた荷物が妥当なら、この配達時間帯の配達を開始する。
-                // このターンはこれで終わり。
-                mTruck.itemGroup().set(itemGroup);
-                for (int i = 0; i < items().count(); ++i) {
-                    if (itemGroup.hasItem(i)) {
-                        mTransportStates[i] = TransportState_Transporting;
-                    }
+            if (mState.state == StageState_Failed) {
+                // 積み込みに失敗した場合も、JSON出力の整合性をとるため、結果は保存する。
+                if (TRecordPolicy::IsTurnResultUpdated) {
+                    updateTurnResult(true, action);
                 }
-                initPeriod = true;
-            }
-            else {
+
                 // トラックに積み込まれた荷物が妥当ではなかった場合は、直ちに終了。
                 // この場合は、結果の保存も行われない。
-                Answer::FinalizePeriod(*this, mTurnResult.state, 0);
-                Answer::Finalize(*this, mTurnResult.state, 0);
+                Answer::FinalizePeriod(*this, mState.state, 0);
+                Answer::Finalize(*this, mState.state, 0);
                 return;
             }
+
+            // この配達時間帯の配達を開始する。このターンはこれで終わり。
+            initPeriod = true;
+
+            // この時間帯の行動計画を受け取る。
+            mActionPlan.reset();
+            mPlanIndex = 0;
+            Answer::InitPeriodPlan(*this, mActionPlan);
         }
         else {
             // 配達中。
-            action = Answer::GetNextAction(*this);
-            int cost = runAction(action);
-            mPeriodCost += cost;
+            if (hasPlannedAction()) {
+                action = mActionPlan[mPlanIndex++];
+            }
+            else {
+                action = Answer::GetNextAction(*this);
+            }
+            runAction(mState, action);
         }
 
         // 結果の保存
-        updateTurnResult(initPeriod, action);
+        if (TRecordPolicy::IsTurnResultUpdated) {
+            updateTurnResult(initPeriod, action);
+        }
 
-        if (truck().itemGroup().hasAnyItems() == false && truck().pos() == field().officePos()) {
+        if (isPeriodEnd(mState)) {
             // トラックが空であり、かつ営業所にいるので、この配達時間帯を終了する。
-            Answer::FinalizePeriod(*this, mTurnResult.state, mPeriodCost);
-            mTotalCost += mPeriodCost;
-            for (int i = 0; i < items().count(); ++i) {
-                if (mTransportStates[i] == TransportState_Transporting) {
-                    mTransportStates[i] = TransportState_Transported;
+            Answer::FinalizePeriod(*this, mState.state, mState.periodCost);
+            mActionPlan.reset();
+            mPlanIndex = 0;
+            finishPeriod(mState);
+        }
+
+        // ターン数が一定数を超えたら終了
+        finishTurn(mState);
+        if (TRecordPolicy::IsTurnResultUpdated) {
+            mTurnResult.state = mState.state;
+        }
+
+        if (mState.state != StageState_Playing) {
+            // 終了
+            Answer::Finalize(*this, mState.state, score());
+        }
+    }
+
+    template void Stage::runTurn<FullRecordPolicy>();
+    template void Stage::runTurn<SummaryRecordPolicy>();
+    template void Stage::runTurn<NoRecordPolicy>();
+
+    //------------------------------------------------------------------------------
+    /// Answer::InitPeriodPlan で設定された行動計画が残っている間、ターンを続けて進めます。
+    ///
+    /// 計画を使い切るか、時間帯やステージが終わるか、制限時間を過ぎたら戻ります。
+    /// 制限時間はターンごとに確かめますが、 Timer::isInTime はフラグを読むだけなので、
+    /// 1ターンずつ呼び出し元に戻るよりずっと軽く済みます。
+    /// 計画を設定しない Answer では何もしないので、続けて runTurn を呼んでください。
+    ///
+    /// @tparam TRecordPolicy 記録方針。
+    /// @param[in]     aTimer   ゲームタイマー。
+    /// @param[in,out] aRecord  毎ターンの結果の記録先。毎ターンを記録しない方針では使わないので、 nullptr でかまいません。
+    template <class TRecordPolicy>
+    void Stage::runPlannedTurns(const Timer& aTimer, RecordStage* aRecord)
+    {
+        HPC_ASSERT(!TRecordPolicy::IsTurnRecorded || aRecord != nullptr);
+        while (mState.state == StageState_Playing && hasPlannedAction() && aTimer.isInTime()) {
+            runTurn<TRecordPolicy>();
+            if (TRecordPolicy::IsTurnRecorded) {
+                aRecord->writeTurn(mTurnResult);
+            }
+        }
+    }
+
+    template void Stage::runPlannedTurns<FullRecordPolicy>(const Timer& aTimer, RecordStage* aRecord);
+    template void Stage::runPlannedTurns<SummaryRecordPolicy>(const Timer& aTimer, RecordStage* aRecord);
+    template void Stage::runPlannedTurns<NoRecordPolicy>(const Timer& aTimer, RecordStage* aRecord);
+
+    //------------------------------------------------------------------------------
+    /// 現在の状態を返します。
+    ///
+    /// 返された値を複製して runTurn(StageSnapshot&, ...) に渡すと、
+    /// このステージを変更せずに先のターンを試すことができます。
+    const StageSnapshot& Stage::snapshot()const
+    {
+        return mState;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 指定した状態で、次のターンが積み込みのターンかどうかを返します。
+    ///
+    /// @return トラックが空で営業所にいる場合は @c true 。
+    bool Stage::isLoadTurn(const StageSnapshot& aSnapshot)const
+    {
+        return aSnapshot.truck.itemGroup().hasAnyItems() == false && aSnapshot.truck.pos() == field().officePos();
+    }
+
+    //------------------------------------------------------------------------------
+    /// 指定した状態で、積み込みのターンを1つ進めます。
+    ///
+    /// Answer の関数は呼ばれません。規則は runTurn() と同じで、
+    /// 積み込みが妥当でなければ状態は StageState_Failed になります。
+    ///
+    /// @param[in,out] aSnapshot  進める状態。 isLoadTurn が @c true である必要があります。
+    /// @param[in] aItemGroup     積み込む荷物。
+    void Stage::runTurn(StageSnapshot& aSnapshot, const ItemGroup& aItemGroup)const
+    {
+        HPC_ASSERT(aSnapshot.state == StageState_Playing);
+        HPC_ASSERT(isLoadTurn(aSnapshot));
+        aSnapshot.period++;
+        aSnapshot.periodCost = 0;
+        loadItems(aSnapshot, aItemGroup);
+        if (aSnapshot.state == StageState_Failed) {
+            return;
+        }
+        if (isPeriodEnd(aSnapshot)) {
+            finishPeriod(aSnapshot);
+        }
+        finishTurn(aSnapshot);
+    }
+
+    //------------------------------------------------------------------------------
+    /// 指定した状態で、配達のターンを1つ進めます。
+    ///
+    /// Answer の関数は呼ばれません。規則は runTurn() と同じです。
+    ///
+    /// @param[in,out] aSnapshot  進める状態。 isLoadTurn が @c false である必要があります。
+    /// @param[in] aAction        トラックの行動。
+    void Stage::runTurn(StageSnapshot& aSnapshot, Action aAction)const
+    {
+        HPC_ASSERT(aSnapshot.state == StageState_Playing);
+        HPC_ASSERT(!isLoadTurn(aSnapshot));
+        runAction(aSnapshot, aAction);
+        if (isPeriodEnd(aSnapshot)) {
+            finishPeriod(aSnapshot);
+        }
+        finishTurn(aSnapshot);
+    }
+
+    //------------------------------------------------------------------------------
+    /// 配達計画どおりにステージを最後まで実行した結果を、1ターンずつ進めずに求めます。
+    ///
+    /// 積み込みの検査、燃料の消費、途中での荷下ろし、ターン数の制限は runTurn と同じ規則で扱われます。
+    /// 経路の選び方は PlanEvaluator を参照してください。
+    /// start() を呼んだ後でなければ使えません。
+    /// 距離と経路の前計算は、ステージごとに最初の呼び出しで行われます。
+    ///
+    /// @param[in]  aPlan    配達計画。
+    /// @param[out] aResult  評価結果。
+    void Stage::evaluatePlan(const DeliveryPlan& aPlan, PlanResult& aResult)const
+    {
+        planEvaluator().evaluate(aPlan, aResult);
+    }
+
+    //------------------------------------------------------------------------------
+    /// まだこのステージ用に作られていなければ、距離と経路を前計算します。
+    ///
+    /// @return 配達計画の評価に使う、営業所と配達先の間の距離情報。
+    const PlanEvaluator& Stage::planEvaluator()const
+    {
+        if (!mIsPlanEvaluatorReady) {
+            mPlanEvaluator.setup(field(), items());
+            mIsPlanEvaluatorReady = true;
+        }
+        return mPlanEvaluator;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 積み込む荷物が妥当か検査し、妥当ならトラックに積み込みます。
+    ///
+    /// 妥当でなければ状態を StageState_Failed にし、トラックには何も積み込みません。
+    void Stage::loadItems(StageSnapshot& aSnapshot, const ItemGroup& aItemGroup)const
+    {
+        const int period = aSnapshot.period;
+        bool isValid = true;
+        int weight = 0;
+        for (int i = 0; i < items().count(); ++i) {
+            const bool isDelivered = aSnapshot.transportedItems.hasItem(i) || aSnapshot.transportingItems.hasItem(i);
+            if (aItemGroup.hasItem(i)) {
+                if (isDelivered) {
+                    // 配達済みの荷物を積み込もうとした。
+                    isValid = false;
+                }
+                if (items()[i].period() >= 0 && items()[i].period() != period) {
+                    // この時間帯に配達すべきではない荷物を積み込んだ。
+                    isValid = false;
+                }
+                weight += items()[i].weight();
+                if (weight > Parameter::TruckWeightCapacity) {
+                    // 最大積載重量を超えて積み込んだ。
+                    isValid = false;
                 }
             }
-            if (mPeriod == Parameter::PeriodCount - 1) {
-                mTurnResult.state = StageState_Complete;
+            else {
+                if (items()[i].period() == period) {
+                    // この時間帯に配達すべき荷物を積み込まなかった。
+                    isValid = false;
+                }
+                if (period == Parameter::PeriodCount - 1 && !isDelivered) {
+                    // 最後の時間帯なのに、残りの荷物をすべて積み込まなかった。
+                    isValid = false;
+                }
+            }
+        }
+        for (int i = items().count(); i < Parameter::ItemCountMax; ++i) {
+            if (aItemGroup.hasItem(i)) {
+                // 存在しない荷物を積み込もうとした。
+                isValid = false;
             }
         }
 
-        // ターン数が一定数を超えたら終了
-        ++mTurnIndex;
-        if (mTurnResult.state == StageState_Playing) {
-            if (mTurnIndex >= Parameter::GameTurnPerStage) {
-                mTurnResult.state = StageState_TurnLimit;
+        if (!isValid) {
+            aSnapshot.state = StageState_Failed;
+            return;
+        }
+
+        aSnapshot.truck.itemGroup().set(aItemGroup);
+        aSnapshot.transportingItems.set(aItemGroup);
+        aSnapshot.loadWeight = weight;
+    }
+
+    //------------------------------------------------------------------------------
+    /// Actionを実行し、消費した燃料をこの時間帯の燃料に加えます。
+    ///
+    /// 積載重量と配達先の表を使うので、荷物数によらず一定の時間で処理できます。
+    void Stage::runAction(StageSnapshot& aSnapshot, Action aAction)const
+    {
+        aSnapshot.periodCost += Parameter::TruckWeight + aSnapshot.loadWeight;
+        Truck& truck = aSnapshot.truck;
+        Pos nextPos = truck.pos().move(aAction);
+        if (field().isWall(nextPos) == false) {
+            truck.setPos(nextPos);
+            // 配達できたか調べる
+            // 配達先は荷物ごとに異なるので、1マスで配達される荷物は高々1つ。
+            const int item = mDestinationItems[nextPos.y][nextPos.x];
+            if (item >= 0 && truck.itemGroup().hasItem(item)) {
+                truck.itemGroup().removeItem(item);
+                aSnapshot.loadWeight -= items()[item].weight();
             }
         }
+    }
 
-        if (mTurnResult.state != StageState_Playing) {
-            // 終了
-            Answer::Finalize(*this, mTurnResult.state, score());
+    //------------------------------------------------------------------------------
+    /// 配達時間帯が終わったかどうかを返します。
+    ///
+    /// @return トラックが空で営業所にいる場合は @c true 。
+    bool Stage::isPeriodEnd(const StageSnapshot& aSnapshot)const
+    {
+        return isLoadTurn(aSnapshot);
+    }
+
+    //------------------------------------------------------------------------------
+    /// 配達時間帯の終了処理を行います。
+    void Stage::finishPeriod(StageSnapshot& aSnapshot)const
+    {
+        aSnapshot.totalCost += aSnapshot.periodCost;
+        aSnapshot.transportedItems.setBits(aSnapshot.transportedItems.getBits() | aSnapshot.transportingItems.getBits());
+        aSnapshot.transportingItems.reset();
+        if (aSnapshot.period == Parameter::PeriodCount - 1) {
+            aSnapshot.state = StageState_Complete;
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// ターンの終了処理を行います。ターン数が一定数を超えたら終了します。
+    void Stage::finishTurn(StageSnapshot& aSnapshot)const
+    {
+        ++aSnapshot.turnIndex;
+        if (aSnapshot.state == StageState_Playing) {
+            if (aSnapshot.turnIndex >= Parameter::GameTurnPerStage) {
+                aSnapshot.state = StageState_TurnLimit;
+            }
         }
     }
 
     //------------------------------------------------------------------------------
     int Stage::score() const
     {
-        if (mTurnResult.state == StageState_Complete) {
-            return field().width() * field().height() * items().count() * 10000 / mTotalCost;
+        return score(mState);
+    }
+
+    //------------------------------------------------------------------------------
+    /// 指定した状態でのスコアを返します。
+    ///
+    /// @return 配達が完了していればスコア。そうでなければ 0 。
+    int Stage::score(const StageSnapshot& aSnapshot) const
+    {
+        if (aSnapshot.state == StageState_Complete) {
+            return field().width() * field().height() * items().count() * 10000 / aSnapshot.totalCost;
         }
         else {
             return 0;
@@ -257,38 +475,62 @@ namespace hpc {
     //------------------------------------------------------------------------------
     const Truck& Stage::truck()const
     {
-        return mTruck;
+        return mState.truck;
     }
 
     //------------------------------------------------------------------------------
     Truck& Stage::truck()
     {
-        return mTruck;
+        return mState.truck;
     }
 
     //------------------------------------------------------------------------------
     int Stage::period() const
     {
-        return mPeriod;
+        return mState.period;
+    }
+
+    //------------------------------------------------------------------------------
+    /// ステージ番号を返します。
+    ///
+    /// 荷物数や時間帯指定の数はステージ番号だけで決まるので、
+    /// Answer がステージをまたいで持ち時間を配るときの手がかりになります。
+    int Stage::number() const
+    {
+        return mNumber;
+    }
+
+    //------------------------------------------------------------------------------
+    void Stage::setNumber(int aNumber)
+    {
+        HPC_RANGE_ASSERT_MIN_UB_I(aNumber, 0, Parameter::GameStageCount);
+        mNumber = aNumber;
     }
 
     //------------------------------------------------------------------------------
     TransportState Stage::getTransportState(int aIndex) const
     {
         HPC_RANGE_ASSERT_MIN_UB_I(aIndex, 0, items().count());
-        return mTransportStates[aIndex];
+        if (mState.transportedItems.hasItem(aIndex)) {
+            return TransportState_Transported;
+        }
+        if (mState.transportingItems.hasItem(aIndex)) {
+            return TransportState_Transporting;
+        }
+        return TransportState_NotTransported;
     }
 
     //------------------------------------------------------------------------------
     /// TurnResultの情報を更新します。
     void Stage::updateTurnResult(bool aInitPeriod, Action aAction)
     {
+        mTurnResult.state = mState.state;
         mTurnResult.initPeriod = aInitPeriod;
         mTurnResult.action = aAction;
         mTurnResult.truckPos = truck().pos();
         mTurnResult.itemGroup.set(truck().itemGroup());
-        mTurnResult.periodCost = mPeriodCost;
-        mTurnResult.totalCost = mTotalCost;
+        mTurnResult.periodCost = mState.periodCost;
+        mTurnResult.totalCost = mState.totalCost;
     }
 }
 
@@ -10,14 +10,23 @@
 //------------------------------------------------------------------------------
 #pragma once
 
+#include "HPCActionPlan.hpp"
 #include "HPCField.hpp"
+#include "HPCDeliveryPlan.hpp"
 #include "HPCItemCollection.hpp"
+#include "HPCPlanEvaluator.hpp"
+#include "HPCPlanResult.hpp"
+#include "HPCRecordPolicy.hpp"
+#include "HPCStageSnapshot.hpp"
 #include "HPCTransportState.hpp"
 #include "HPCTruck.hpp"
 #include "HPCTurnResult.hpp"
 
 namespace hpc {
 
+    class RecordStage;
+    class Timer;
+
     //------------------------------------------------------------------------------
     /// ゲームの1ステージを表します。
     class Stage 
@@ -28,8 +37,29 @@ namespace hpc {
         ///@name ステージの実行
         //@{
         void start(bool aIsInTime);                     ///< ステージを開始します。
+        template <class TRecordPolicy = FullRecordPolicy>
         void runTurn();                                 ///< ターンを1つ進めます。
+        template <class TRecordPolicy = FullRecordPolicy>
+        void runPlannedTurns(const Timer& aTimer, RecordStage* aRecord); ///< 行動計画が残っている間、ターンを続けて進めます。
         const TurnResult& lastTurnResult()const;        ///< 最後のターン実行後の結果を返します。
+        StageState state()const;                       ///< 現在の状態を返します。
+        bool hasPlannedAction()const;                  ///< 行動計画に未実行の行動が残っているかを返します。
+        const ItemGroup& lastLoadItems()const;         ///< 最後の積み込みで Answer が指定した荷物を返します。
+        //@}
+
+        ///@name 状態を複製した試行
+        //@{
+        const StageSnapshot& snapshot()const;                                  ///< 現在の状態を返します。
+        bool isLoadTurn(const StageSnapshot& aSnapshot)const;                  ///< 次のターンが積み込みかどうかを返します。
+        void runTurn(StageSnapshot& aSnapshot, const ItemGroup& aItemGroup)const; ///< 積み込みのターンを1つ進めます。
+        void runTurn(StageSnapshot& aSnapshot, Action aAction)const;           ///< 配達のターンを1つ進めます。
+        int score(const StageSnapshot& aSnapshot)const;                        ///< スコアを返します。
+        //@}
+
+        ///@name 配達計画の評価
+        //@{
+        void evaluatePlan(const DeliveryPlan& aPlan, PlanResult& aResult)const; ///< 配達計画を最後まで実行した結果を求めます。
+        const PlanEvaluator& planEvaluator()const;                             ///< 配達計画の評価に使う距離情報を返します。
         //@}
 
         /// @name 各要素へのアクセス
@@ -41,22 +71,30 @@ namespace hpc {
         const Truck& truck()const;          ///< トラック情報を返します。
         Truck& truck();                     ///< トラック情報を返します。
         int period() const;                 ///< 現在の配達時間帯を返します。
+        int number() const;                 ///< ステージ番号を返します。
+        void setNumber(int aNumber);        ///< ステージ番号を設定します。
         TransportState getTransportState(int aIndex) const; ///< 指定荷物の配達状況を取得します。
         //@}
         int score() const;                  ///< スコアを返します。
 
     private:
-        int runAction(Action aAction); ///< Actionを実行します。
+        void loadItems(StageSnapshot& aSnapshot, const ItemGroup& aItemGroup)const; ///< 荷物を検査して積み込みます。
+        void runAction(StageSnapshot& aSnapshot, Action aAction)const;             ///< Actionを実行します。
+        bool isPeriodEnd(const StageSnapshot& aSnapshot)const;                     ///< 配達時間帯が終わったかどうかを返します。
+        void finishPeriod(StageSnapshot& aSnapshot)const;                          ///< 配達時間帯の終了処理を行います。
+        void finishTurn(StageSnapshot& aSnapshot)const;                            ///< ターンの終了処理を行います。
 
         Field mField;                   ///< フィールド情報
-        int mPeriod;                    ///< 配達時間帯。0 ～ PeriodCount - 1
-        int mPeriodCost;                ///< この時間帯に消費した燃料。
-        int mTotalCost;                 ///< この時間帯までに消費した燃料。
         ItemCollection mItems;          ///< 荷物情報
-        TransportState mTransportStates[Parameter::ItemCountMax]; ///< 配達状況
-        Truck mTruck;                   ///< トラック情報
+        int mNumber;                    ///< ステージ番号
+        StageSnapshot mState;           ///< 進行に伴って変化する状態
         TurnResult mTurnResult;         ///< ターンの実行結果
-        int mTurnIndex;                 ///< 現在のターン番号
+        int mDestinationItems[Parameter::FieldHeightMax][Parameter::FieldWidthMax]; ///< マスごとの、そこを配達先とする荷物番号。なければ -1。
+        ActionPlan mActionPlan;         ///< この時間帯の行動計画
+        int mPlanIndex;                 ///< 行動計画の次に実行する番号
+        mutable PlanEvaluator mPlanEvaluator;   ///< 配達計画の評価器。最初に使われたときに作る
+        mutable bool mIsPlanEvaluatorReady;     ///< mPlanEvaluator がこのステージ用に作られているかどうか
+        ItemGroup mLoadItems;           ///< 最後の積み込みで Answer が指定した荷物
 
         void updateTurnResult(bool aInitPeriod, Action aAction); ///< TurnResultを更新します。
     };
@@ -0,0 +1,100 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief    HPCStageCheckpoint.hpp の実装
+/// @author   ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+
+#include "HPCStageCheckpoint.hpp"
+
+#include "HPCCommon.hpp"
+#include "HPCLevelDesigner.hpp"
+#include "HPCMath.hpp"
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// クラスのインスタンスを生成します。
+    StageCheckpoint::StageCheckpoint()
+        : mRandoms()
+        , mCount(0)
+    {
+    }
+
+    //------------------------------------------------------------------------------
+    /// 記録を破棄します。
+    void StageCheckpoint::reset()
+    {
+        mCount = 0;
+    }
+
+    //------------------------------------------------------------------------------
+    /// ステージ開始時点、つまり LevelDesigner::Setup を呼ぶ直前の乱数を記録します。
+    ///
+    /// 記録済みのステージを書き直しても、その先の記録は消えません。
+    /// ステージの生成は乱数だけで決まるので、書き直す値は記録済みの値と同じである必要があります。
+    ///
+    /// @param[in] aStageIndex ステージ番号。記録済みのステージ数以下である必要があります。
+    /// @param[in] aRandom     ステージ開始時点の乱数。
+    void StageCheckpoint::write(int aStageIndex, const Random& aRandom)
+    {
+        HPC_RANGE_ASSERT_MIN_MAX_I(aStageIndex, 0, mCount);
+        HPC_RANGE_ASSERT_MIN_UB_I(aStageIndex, 0, Parameter::GameStageCount);
+        HPC_ASSERT_MSG(aStageIndex == mCount || mRandoms[aStageIndex] == aRandom, "Checkpoint of stage #%d does not match the recorded one.", aStageIndex);
+        mRandoms[aStageIndex] = aRandom;
+        mCount = Math::Max(mCount, aStageIndex + 1);
+    }
+
+    //------------------------------------------------------------------------------
+    /// 乱数の初期状態から全ステージを順番に生成し、各ステージ開始時点の乱数を記録します。
+    ///
+    /// @param[in] aRandom 最初のステージ開始時点の乱数。引数の乱数は進みません。
+    void StageCheckpoint::build(const Random& aRandom)
+    {
+        Random random = aRandom;
+        Stage stage;
+        for (int i = 0; i < Parameter::GameStageCount; ++i) {
+            write(i, random);
+            LevelDesigner::Setup(i, stage, random);
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// @param[in] aStageIndex ステージ番号。
+    ///
+    /// @return 指定ステージ開始時点の乱数が記録されていれば @c true 。
+    bool StageCheckpoint::hasStage(int aStageIndex)const
+    {
+        return 0 <= aStageIndex && aStageIndex < mCount;
+    }
+
+    //------------------------------------------------------------------------------
+    /// @param[in] aStageIndex 記録済みのステージ番号。
+    ///
+    /// @return 指定ステージ開始時点の乱数。
+    const Random& StageCheckpoint::random(int aStageIndex)const
+    {
+        HPC_RANGE_ASSERT_MIN_UB_I(aStageIndex, 0, mCount);
+        return mRandoms[aStageIndex];
+    }
+
+    //------------------------------------------------------------------------------
+    /// 記録した乱数から、指定ステージを直接生成します。
+    ///
+    /// 生成されるステージは、先頭から順番に生成した場合と同じになります。
+    ///
+    /// @param[in]     aStageIndex 記録済みのステージ番号。
+    /// @param[in,out] aStage      ステージ情報。関数を呼ぶと書き換えられます。
+    void StageCheckpoint::setupStage(int aStageIndex, Stage& aStage)const
+    {
+        Random stageRandom = random(aStageIndex);
+        LevelDesigner::Setup(aStageIndex, aStage, stageRandom);
+    }
+}
+
+//------------------------------------------------------------------------------
+// EOF
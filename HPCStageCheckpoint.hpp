@@ -0,0 +1,44 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief    StageCheckpoint クラス
+/// @author   ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "HPCParameter.hpp"
+#include "HPCRandom.hpp"
+#include "HPCStage.hpp"
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// 各ステージ開始時点の乱数の状態を保持します。
+    ///
+    /// ステージの生成は1つの乱数を順番に消費するため、そのままでは
+    /// ステージ k を作るのに 0 ～ k-1 のステージをすべて生成する必要があります。
+    /// 開始時点の乱数を控えておくことで、任意のステージを直接生成できます。
+    class StageCheckpoint
+    {
+    public:
+        StageCheckpoint();
+
+        void reset();                                           ///< 記録を破棄します。
+        void write(int aStageIndex, const Random& aRandom);     ///< ステージ開始時点の乱数を記録します。
+        void build(const Random& aRandom);                      ///< 全ステージ分の乱数を求めます。
+
+        bool hasStage(int aStageIndex)const;                   ///< 指定ステージの乱数が記録されているかを返します。
+        const Random& random(int aStageIndex)const;            ///< 指定ステージ開始時点の乱数を返します。
+        void setupStage(int aStageIndex, Stage& aStage)const;  ///< 指定ステージを直接生成します。
+
+    private:
+        Random mRandoms[Parameter::GameStageCount];     ///< 各ステージ開始時点の乱数
+        int mCount;                                     ///< 先頭から記録済みのステージ数
+    };
+}
+//------------------------------------------------------------------------------
+// EOF
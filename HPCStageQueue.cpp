@@ -0,0 +1,74 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief    HPCStageQueue.hpp の実装
+/// @author   ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+
+#include "HPCStageQueue.hpp"
+
+#include "HPCCommon.hpp"
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// クラスのインスタンスを生成します。
+    StageQueue::StageQueue()
+        : mMutex()
+        , mCondition()
+        , mValues()
+        , mIsClosed(false)
+    {
+    }
+
+    //------------------------------------------------------------------------------
+    /// 末尾に番号を追加し、待っているスレッドを1つ起こします。
+    ///
+    /// @param[in] aValue 追加する番号。
+    void StageQueue::push(int aValue)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            HPC_ASSERT(!mIsClosed);
+            mValues.push_back(aValue);
+        }
+        mCondition.notify_one();
+    }
+
+    //------------------------------------------------------------------------------
+    /// 先頭から番号を取り出します。空の場合は、追加されるか close されるまで待ちます。
+    ///
+    /// @param[out] aValue 取り出した番号。
+    /// @return 取り出せた場合は @c true 。 close された後で空の場合は @c false 。
+    bool StageQueue::pop(int& aValue)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        while (mValues.empty() && !mIsClosed) {
+            mCondition.wait(lock);
+        }
+        if (mValues.empty()) {
+            return false;
+        }
+        aValue = mValues.front();
+        mValues.pop_front();
+        return true;
+    }
+
+    //------------------------------------------------------------------------------
+    /// これ以上追加しないことを通知し、待っているスレッドをすべて起こします。
+    void StageQueue::close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mIsClosed = true;
+        }
+        mCondition.notify_all();
+    }
+}
+
+//------------------------------------------------------------------------------
+// EOF
@@ -0,0 +1,40 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief    StageQueue クラス
+/// @author   ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// スレッド間で番号を受け渡す、待ち合わせ付きのキューを表します。
+    ///
+    /// 取り出す側は、番号が追加されるか close されるまで待ちます。
+    class StageQueue
+    {
+    public:
+        StageQueue();
+
+        void push(int aValue);          ///< 末尾に番号を追加します。
+        bool pop(int& aValue);          ///< 先頭から番号を取り出します。
+        void close();                   ///< これ以上追加しないことを通知します。
+
+    private:
+        std::mutex mMutex;              ///< 排他制御
+        std::condition_variable mCondition; ///< 追加と close の通知
+        std::deque<int> mValues;        ///< 番号
+        bool mIsClosed;                 ///< close されたか
+    };
+}
+//------------------------------------------------------------------------------
+// EOF
@@ -0,0 +1,120 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief    HPCStageScheduler.hpp の実装
+/// @author   ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+
+#include "HPCStageScheduler.hpp"
+
+#include "HPCCommon.hpp"
+#include "HPCLevelDesigner.hpp"
+#include "HPCParameter.hpp"
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// クラスのインスタンスを生成します。
+    ///
+    /// @param[in] aWorkerCount ワーカー数。1 以上。
+    StageScheduler::StageScheduler(int aWorkerCount)
+        : mQueues()
+    {
+        HPC_LB_ASSERT_I(aWorkerCount, 0);
+        for (int i = 0; i < aWorkerCount; ++i) {
+            mQueues.push_back(std::unique_ptr<Queue>(new Queue()));
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// 全ステージを、実行コストの重いものから順にワーカーへ配ります。
+    ///
+    /// 実行コストは荷物数でおおよそ決まるので、荷物数の多いステージから順に
+    /// 各ワーカーへ1つずつ配ります。
+    /// 各キューは重い順に並ぶので、重いステージが最初にまとめて実行され、
+    /// 終盤は軽いステージの盗み合いで負荷が均されます。
+    void StageScheduler::setupCostlyFirst()
+    {
+        int worker = 0;
+        for (int itemCount = Parameter::ItemCountMax; itemCount > 0; --itemCount) {
+            for (int stage = 0; stage < Parameter::GameStageCount; ++stage) {
+                if (LevelDesigner::ItemCount(stage) == itemCount) {
+                    push(worker, stage);
+                    worker = (worker + 1) % workerCount();
+                }
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// ワーカーのキューの末尾にステージを追加します。
+    ///
+    /// @param[in] aWorkerIndex ワーカー番号。
+    /// @param[in] aStageIndex  ステージ番号。
+    void StageScheduler::push(int aWorkerIndex, int aStageIndex)
+    {
+        HPC_RANGE_ASSERT_MIN_UB_I(aWorkerIndex, 0, workerCount());
+        Queue& queue = *mQueues[aWorkerIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.stages.push_back(aStageIndex);
+    }
+
+    //------------------------------------------------------------------------------
+    /// ワーカーが次に実行するステージを取り出します。
+    ///
+    /// 自分のキューが空の場合は、他のワーカーから盗みます。
+    ///
+    /// @param[in]  aWorkerIndex ワーカー番号。
+    /// @param[out] aStageIndex  取り出したステージ番号。
+    ///
+    /// @return 取り出せた場合は @c true 、すべてのキューが空の場合は @c false 。
+    bool StageScheduler::pop(int aWorkerIndex, int& aStageIndex)
+    {
+        HPC_RANGE_ASSERT_MIN_UB_I(aWorkerIndex, 0, workerCount());
+        {
+            Queue& queue = *mQueues[aWorkerIndex];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.stages.empty()) {
+                aStageIndex = queue.stages.front();
+                queue.stages.pop_front();
+                return true;
+            }
+        }
+        return steal(aWorkerIndex, aStageIndex);
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return ワーカー数。
+    int StageScheduler::workerCount()const
+    {
+        return static_cast<int>(mQueues.size());
+    }
+
+    //------------------------------------------------------------------------------
+    /// 隣のワーカーから順に、キューの末尾のステージを盗みます。
+    ///
+    /// @param[in]  aWorkerIndex 盗む側のワーカー番号。
+    /// @param[out] aStageIndex  盗んだステージ番号。
+    ///
+    /// @return 盗めた場合は @c true 、他のキューがすべて空の場合は @c false 。
+    bool StageScheduler::steal(int aWorkerIndex, int& aStageIndex)
+    {
+        for (int i = 1; i < workerCount(); ++i) {
+            Queue& victim = *mQueues[(aWorkerIndex + i) % workerCount()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.stages.empty()) {
+                aStageIndex = victim.stages.back();
+                victim.stages.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+//------------------------------------------------------------------------------
+// EOF
@@ -0,0 +1,49 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief    StageScheduler クラス
+/// @author   ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// ステージを複数のワーカーに配る、ワークスティーリング方式のスケジューラを表します。
+    ///
+    /// ワーカーごとにステージ番号のキューを持ちます。
+    /// ワーカーは自分のキューの先頭から取り出し、空になったら他のワーカーのキューの末尾から盗みます。
+    class StageScheduler
+    {
+    public:
+        StageScheduler(int aWorkerCount);
+
+        void setupCostlyFirst();                        ///< 全ステージを重い順にワーカーへ配ります。
+        void push(int aWorkerIndex, int aStageIndex);   ///< ワーカーのキューにステージを追加します。
+        bool pop(int aWorkerIndex, int& aStageIndex);   ///< ワーカーが次に実行するステージを取り出します。
+        int workerCount()const;                        ///< ワーカー数を返します。
+
+    private:
+        /// ワーカーごとのキュー
+        struct Queue
+        {
+            std::mutex mutex;           ///< キューの排他制御
+            std::deque<int> stages;     ///< ステージ番号
+        };
+
+        bool steal(int aWorkerIndex, int& aStageIndex); ///< 他のワーカーからステージを盗みます。
+
+        std::vector<std::unique_ptr<Queue> > mQueues;   ///< ワーカーごとのキュー
+    };
+}
+//------------------------------------------------------------------------------
+// EOF
@@ -0,0 +1,53 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief    HPCStageSnapshot.hpp の実装
+/// @author   ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+
+#include "HPCStageSnapshot.hpp"
+
+#include "HPCCommon.hpp"
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// クラスのインスタンスを生成します。
+    StageSnapshot::StageSnapshot()
+        : truck()
+        , transportingItems()
+        , transportedItems()
+        , period(0)
+        , periodCost(0)
+        , totalCost(0)
+        , loadWeight(0)
+        , turnIndex(0)
+        , state(StageState_TERM)
+    {
+    }
+
+    //------------------------------------------------------------------------------
+    /// 値をステージ開始前の状態で初期化します。
+    ///
+    /// 配達時間帯は -1 で、最初の積み込み時にインクリメントされます。
+    /// トラックの位置は変更しないので、別途営業所に設定する必要があります。
+    void StageSnapshot::reset()
+    {
+        truck.itemGroup().reset();
+        transportingItems.reset();
+        transportedItems.reset();
+        period = -1;
+        periodCost = 0;
+        totalCost = 0;
+        loadWeight = 0;
+        turnIndex = 0;
+        state = StageState_Playing;
+    }
+}
+
+//------------------------------------------------------------------------------
+// EOF
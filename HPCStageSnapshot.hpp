@@ -0,0 +1,49 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief    StageSnapshot クラス
+/// @author   ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <type_traits>
+
+#include "HPCItemGroup.hpp"
+#include "HPCStageState.hpp"
+#include "HPCTruck.hpp"
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// ステージの進行に伴って変化する状態を表します。
+    ///
+    /// フィールドや荷物のような変化しない情報は含まないので、数十バイトしかなく、
+    /// 代入だけで複製できます。
+    /// Stage::snapshot で現在の状態を複製し、 Stage::runTurn に渡して進めることで、
+    /// 本物のステージと同じ規則で「この先どうなるか」を試すことができます。
+    struct StageSnapshot
+    {
+        StageSnapshot();
+
+        void reset();                       ///< 情報を初期化します。
+
+        Truck truck;                        ///< トラック情報
+        ItemGroup transportingItems;        ///< 今の時間帯に配達する荷物
+        ItemGroup transportedItems;         ///< 前の時間帯までに配達済みの荷物
+        int period;                         ///< 配達時間帯。0 ～ PeriodCount - 1
+        int periodCost;                     ///< この時間帯に消費した燃料。
+        int totalCost;                      ///< この時間帯までに消費した燃料。
+        int loadWeight;                     ///< トラックに積まれている荷物の重さの合計
+        int turnIndex;                      ///< 現在のターン番号
+        StageState state;                   ///< 現在の状態
+    };
+
+    // 探索で大量に複製するので、メンバーを足すときも memcpy で複製できる型に保つ。
+    static_assert(std::is_trivially_copyable<StageSnapshot>::value, "StageSnapshot must stay trivially copyable.");
+}
+//------------------------------------------------------------------------------
+// EOF
@@ -11,27 +11,28 @@
 
 #include "HPCTimer.hpp"
 
-namespace {
+#include <chrono>
 
-    //------------------------------------------------------------------------------
-    /// 現在の時間を取得します。
-    ///
-    /// @return 現在の時刻を表す std::clock_t 型オブジェクト。
-    std::clock_t GetCurrentTime()
-    {
-        return ::std::clock();
-    }
+#include "HPCCommon.hpp"
+
+namespace {
 
     //------------------------------------------------------------------------------
-    /// std::clock_t で表される時間を秒に変換します。
+    /// 現在の時間を秒で取得します。
     ///
-    /// @param[in] aTime std::clock_t 型で表される時間
+    /// @param[in] aClock 測る時間の種類。
     ///
-    /// @return aTime を秒に変換した値。
-    double ToSec(std::clock_t aTime)
+    /// @return 現在の時刻を秒に変換した値。起点は種類によって異なるので、差だけが意味を持ちます。
+    double GetCurrentSec(hpc::TimerClock aClock)
     {
-        return static_cast<double>(aTime) / CLOCKS_PER_SEC;
+        if (aClock == hpc::TimerClock_WallTime) {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+        return static_cast<double>(::std::clock()) / CLOCKS_PER_SEC;
     }
+
+    /// 監視スレッドが経過時間を調べる間隔。
+    const std::chrono::milliseconds WatchInterval(1);
 }
 
 namespace hpc {
@@ -45,24 +46,92 @@ namespace hpc {
     /// @param[in] aLimitSec 制限時間を秒で指定。
     Timer::Timer(int aLimitSec)
         : mLimitSec(aLimitSec)
-        , mTimeBegin(std::clock_t())
+        , mClock(TimerClock_ProcessTime)
+        , mBeginSec(0.0)
+        , mEndSec(0.0)
+        , mIsStopped(false)
+        , mIsExpired(false)
+        , mIsWatching(false)
+        , mWatchThread()
     {
     }
 
+    //------------------------------------------------------------------------------
+    /// 監視スレッドが動いていれば終了させます。
+    Timer::~Timer()
+    {
+        stopWatch();
+    }
+
     //------------------------------------------------------------------------------
     /// タイマーの計測を開始します。
-    void Timer::start()
+    ///
+    /// 制限時間がある場合は、監視スレッドを開始します。
+    ///
+    /// @param[in] aClock 測る時間の種類。
+    void Timer::start(TimerClock aClock)
+    {
+        HPC_ENUM_ASSERT(TimerClock, aClock);
+        stopWatch();
+        mClock = aClock;
+        mBeginSec = GetCurrentSec(mClock);
+        mIsStopped = false;
+        mIsExpired.store(false, std::memory_order_relaxed);
+        if (mLimitSec != 0) {
+            mIsWatching.store(true, std::memory_order_relaxed);
+            mWatchThread = std::thread(&Timer::watch, this);
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// タイマーの計測を停止します。
+    ///
+    /// 停止後は、経過時間と制限時間内かどうかが停止した時点の値に固定されます。
+    /// そのため、ゲームが制限時間内に終わっていれば、その後の出力に時間がかかっても時間切れになりません。
+    void Timer::stop()
     {
-        mTimeBegin = GetCurrentTime();
+        stopWatch();
+        mEndSec = GetCurrentSec(mClock);
+        mIsStopped = true;
+        if (mLimitSec != 0 && mEndSec - mBeginSec >= mLimitSec) {
+            mIsExpired.store(true, std::memory_order_relaxed);
+        }
     }
 
     //------------------------------------------------------------------------------
     /// start 関数を呼び出した時点からの経過時間を取得します。
     ///
     /// @return start を呼び出してからの経過時間を秒に変換したもの。
+    ///         停止している場合は、停止するまでの経過時間。
     double Timer::pastSec()const
     {
-        return ToSec(GetCurrentTime() - mTimeBegin);
+        return (mIsStopped ? mEndSec : GetCurrentSec(mClock)) - mBeginSec;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 監視スレッドの処理です。
+    ///
+    /// 一定間隔で経過時間を調べ、制限時間を超過したらフラグを立てて終了します。
+    /// 超過が isInTime に反映されるまでには、最大でこの間隔だけ遅れます。
+    void Timer::watch()
+    {
+        while (mIsWatching.load(std::memory_order_relaxed)) {
+            if (GetCurrentSec(mClock) - mBeginSec >= mLimitSec) {
+                mIsExpired.store(true, std::memory_order_relaxed);
+                return;
+            }
+            std::this_thread::sleep_for(WatchInterval);
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// 監視スレッドが動いていれば終了させ、終わるまで待ちます。
+    void Timer::stopWatch()
+    {
+        mIsWatching.store(false, std::memory_order_relaxed);
+        if (mWatchThread.joinable()) {
+            mWatchThread.join();
+        }
     }
 
     //------------------------------------------------------------------------------
@@ -81,11 +150,13 @@ namespace hpc {
     }
 
     //------------------------------------------------------------------------------
+    /// 監視スレッドが立てたフラグを読むだけなので、時刻の取得は行いません。
+    ///
     /// @return 制限時間以内の場合 @c false を返し、
     ///         超過した場合は @c true を返します。
     bool Timer::isInTime()const
     {
-        return mLimitSec == 0 || pastSec() < mLimitSec;
+        return !mIsExpired.load(std::memory_order_relaxed);
     }
 }
 //------------------------------------------------------------------------------
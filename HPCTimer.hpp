@@ -10,26 +10,53 @@
 //------------------------------------------------------------------------------
 #pragma once
 
+#include <atomic>
 #include <ctime>
+#include <thread>
 
 namespace hpc {
 
+    //------------------------------------------------------------------------------
+    /// @brief タイマーが測る時間の種類を表します。
+    enum TimerClock {
+        TimerClock_ProcessTime, ///< プロセスが使った CPU 時間。複数スレッドで実行すると全スレッドの合計になる
+        TimerClock_WallTime,    ///< 実時間
+
+        TimerClock_TERM
+    };
+
     //------------------------------------------------------------------------------
     /// 実時間計測を行うタイマーを提供します。
+    ///
+    /// 制限時間がある場合は、監視スレッドが一定間隔で経過時間を調べ、超過したらフラグを立てます。
+    /// isInTime はフラグを読むだけなので、毎ターン呼んでも時刻の取得は発生しません。
+    ///
+    /// 既定では CPU 時間を測ります。ステージを複数スレッドで実行する場合は、
+    /// CPU 時間がスレッド数の分だけ速く進むので、実時間を測ってください。
     class Timer
     {
     public:
         Timer(int aLimitSec);               ///< 制限時間を定めてインスタンスを生成します。
+        ~Timer();
 
-        void start();                       ///< タイマーを開始します。
+        void start(TimerClock aClock = TimerClock_ProcessTime); ///< タイマーを開始します。
+        void stop();                        ///< タイマーを停止します。
         bool isInTime()const;              ///< 制限時間内かどうかを返します。
         double pastSecForPrint()const;     ///< 表示用の経過時間を取得します。
 
     private:
         double pastSec()const;             ///< 経過時間を取得します。
+        void watch();                       ///< 監視スレッドの処理です。
+        void stopWatch();                   ///< 監視スレッドを終了させます。
 
         const int mLimitSec;                ///< 制限時間
-        std::clock_t mTimeBegin;            ///< 開始時刻
+        TimerClock mClock;                  ///< 測る時間の種類
+        double mBeginSec;                   ///< 開始時刻 [秒]
+        double mEndSec;                     ///< 停止時刻 [秒]
+        bool mIsStopped;                    ///< 停止したか
+        std::atomic<bool> mIsExpired;       ///< 制限時間を超過したか
+        std::atomic<bool> mIsWatching;      ///< 監視を続けるか
+        std::thread mWatchThread;           ///< 監視スレッド
     };
 }
 //------------------------------------------------------------------------------
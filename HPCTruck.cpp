@@ -12,24 +12,24 @@
 #include "HPCTruck.hpp"
 
 #include "HPCCommon.hpp"
-#include "HPCStage.hpp"
 
 namespace hpc {
 
     //------------------------------------------------------------------------------
     /// クラスのインスタンスを生成します。
-    Truck::Truck(const Stage& aStage)
-        : mStage(aStage)
-        , mPos()
+    Truck::Truck()
+        : mPos()
         , mItemGroup()
     {
     }
 
     //------------------------------------------------------------------------------
     /// リセットします。
-    void Truck::reset()
+    ///
+    /// @param[in] aOfficePos 営業所の位置。トラックはここから出発します。
+    void Truck::reset(const Pos& aOfficePos)
     {
-        mPos = mStage.field().officePos();
+        mPos = aOfficePos;
         mItemGroup.reset();
     }
 
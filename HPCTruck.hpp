@@ -16,17 +16,16 @@
 
 namespace hpc {
 
-    class Stage;
-
     //------------------------------------------------------------------------------
     /// トラックを表します。
     ///
+    /// 位置と荷物だけを持つので、代入で複製できます。
     class Truck
     {
     public:
-        Truck(const Stage& aStage);
+        Truck();
 
-        void reset();                   ///< 初期化
+        void reset(const Pos& aOfficePos);  ///< 初期化
 
         const Pos& pos() const;         ///< 現在位置を取得する
         void setPos(const Pos& aPos);   ///< 現在位置を設定する
@@ -34,7 +33,6 @@ namespace hpc {
         ItemGroup& itemGroup();             ///< 荷物グループを取得する。
 
     private:
-        const Stage& mStage;      ///< ステージ
         Pos mPos;           ///< トラックの位置
         ItemGroup mItemGroup;
     };